@@ -0,0 +1,97 @@
+// gain_bench.cpp
+// audio_gain_s16 kernel'lerini eski apply_volume_s16 ile karşılaştırır
+// (48 kHz stereo, SDL callback boyutunda buffer'lar).
+
+#include "audio_gain.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// player.cpp'deki eski implementasyon (referans)
+static void apply_volume_s16_legacy(uint8_t* data, int nbytes, float vol01) {
+    if (!data) return;
+    if (vol01 < 0.f) vol01 = 0.f;
+    if (vol01 > 1.f) vol01 = 1.f;
+    int16_t* p = (int16_t*)data;
+    int count = nbytes / 2;
+    for (int i = 0; i < count; ++i) {
+        int v = (int)std::lround(p[i] * vol01);
+        if (v >  32767) v =  32767;
+        if (v < -32768) v = -32768;
+        p[i] = (int16_t)v;
+    }
+}
+
+static const int FRAMES   = 1024;          // SDL callback boyutu
+static const int CHANNELS = 2;
+static const int SAMPLES  = FRAMES * CHANNELS;
+static const int SECONDS  = 600;           // 10 dakika ses
+static const int ITERS    = SECONDS * 48000 / FRAMES;
+
+template <typename F>
+static double run(const std::vector<int16_t>& src, std::vector<int16_t>& buf, F fn) {
+    double total = 0.0;
+    for (int it = 0; it < ITERS; ++it) {
+        std::memcpy(buf.data(), src.data(), SAMPLES * sizeof(int16_t));
+        auto t0 = std::chrono::steady_clock::now();
+        fn(buf.data(), it);
+        auto t1 = std::chrono::steady_clock::now();
+        total += std::chrono::duration<double>(t1 - t0).count();
+    }
+    return total;
+}
+
+int main() {
+    std::vector<int16_t> src(SAMPLES), buf(SAMPLES), ref(SAMPLES), out(SAMPLES);
+    std::srand(1234);
+    for (auto& s : src) s = (int16_t)(std::rand() % 65536 - 32768);
+
+    const float vol = 0.7f;
+    std::printf("%d x %d-frame stereo buffers (%d s @ 48 kHz)\n", ITERS, FRAMES, SECONDS);
+
+    double t_legacy = run(src, buf, [&](int16_t* p, int) {
+        apply_volume_s16_legacy((uint8_t*)p, SAMPLES * 2, vol);
+    });
+    std::printf("  %-8s %8.3f ms  %7.1f Msamples/s\n", "legacy", t_legacy * 1e3,
+                (double)ITERS * SAMPLES / t_legacy / 1e6);
+
+    // Doğruluk: sabit kazançta eskiyle en fazla 1 LSB fark (Q15 yuvarlama)
+    std::memcpy(ref.data(), src.data(), SAMPLES * sizeof(int16_t));
+    apply_volume_s16_legacy((uint8_t*)ref.data(), SAMPLES * 2, vol);
+
+    std::vector<int16_t> ramp_scalar(src);
+    audio_gain_s16_kernel(AUDIO_GAIN_SCALAR, ramp_scalar.data(), SAMPLES, 0.2f, 0.9f);
+
+    int rc = 0;
+    for (AudioGainKernel k : { AUDIO_GAIN_SCALAR, AUDIO_GAIN_SSE2, AUDIO_GAIN_AVX2 }) {
+        if (!audio_gain_kernel_supported(k)) {
+            std::printf("  %-8s (not supported on this CPU)\n", audio_gain_kernel_name(k));
+            continue;
+        }
+        double t = run(src, buf, [&](int16_t* p, int) {
+            audio_gain_s16_kernel(k, p, SAMPLES, vol, vol);
+        });
+
+        std::memcpy(out.data(), src.data(), SAMPLES * sizeof(int16_t));
+        audio_gain_s16_kernel(k, out.data(), SAMPLES, vol, vol);
+        int max_diff = 0;
+        for (int i = 0; i < SAMPLES; ++i) {
+            int d = std::abs(out[i] - ref[i]);
+            if (d > max_diff) max_diff = d;
+        }
+        std::vector<int16_t> ramp(src);
+        audio_gain_s16_kernel(k, ramp.data(), SAMPLES, 0.2f, 0.9f);
+        bool ramp_ok = std::memcmp(ramp.data(), ramp_scalar.data(), SAMPLES * sizeof(int16_t)) == 0;
+        if (max_diff > 1 || !ramp_ok) rc = 1;
+
+        std::printf("  %-8s %8.3f ms  %7.1f Msamples/s  x%.1f  max|diff|=%d  ramp==scalar: %s\n",
+                    audio_gain_kernel_name(k), t * 1e3, (double)ITERS * SAMPLES / t / 1e6,
+                    t_legacy / t, max_diff, ramp_ok ? "yes" : "NO");
+    }
+    std::printf("dispatch: %s\n", audio_gain_kernel_name(audio_gain_best_kernel()));
+    return rc;
+}
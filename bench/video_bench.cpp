@@ -0,0 +1,289 @@
+// video_bench.cpp
+// Headless decode benchmark: pencere/ses cihazı açmadan dosyayı olabildiğince
+// hızlı demux + decode eder (video: sws_scale -> RGB0, ses: swr_convert -> s16 48k).
+// Çıktı: kare/s, sample/s, aşama süreleri ve peak RSS.
+// --seeks N: bunun yerine N seek'te hedef kareye ulaşma süresi/isabeti (fast vs accurate).
+
+#include "demuxer.hpp"
+#include "sound_reader.hpp"
+#include "stage_trace.hpp"
+#include "video_reader.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+struct BenchOptions {
+    VideoDecodeOptions video_decode;
+    bool video = true, audio = true;
+    int  seeks = 0;
+    int  out_w = 0, out_h = 0; // --size: çizilen boyuta dönüşüm (scale_to_display)
+    std::string path;
+    std::string trace_path; // --trace: Chrome trace JSON
+};
+
+static void print_usage(const char* argv0) {
+    std::printf("Usage: %s [options] <video>\n"
+                "  --threads <auto|N>                 video decoder thread count\n"
+                "  --thread-type <auto|frame|slice>   video decoder threading mode\n"
+                "  --convert-threads <auto|N>         threads for YUV -> RGB conversion\n"
+                "  --swscale                          always convert with swscale\n"
+                "  --frame-pool <auto|off|N>          decoder frame buffer pool capacity\n"
+                "  --size <WxH>                       convert to this drawn size (scale-to-display)\n"
+                "  --no-video                         skip the video stream\n"
+                "  --no-audio                         skip the audio stream\n"
+                "  --seeks <N>                        measure N seeks (fast and accurate) instead\n"
+                "  --trace <file>                     write per-stage timings as Chrome trace JSON\n",
+                argv0);
+}
+
+static bool parse_args(int argc, const char** argv, BenchOptions* opts) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!std::strcmp(a, "--threads") && val) {
+            if (!std::strcmp(val, "auto")) opts->video_decode.thread_count = 0;
+            else {
+                int n = std::atoi(val);
+                if (n < 1) return false;
+                opts->video_decode.thread_count = n;
+            }
+            ++i;
+        } else if (!std::strcmp(a, "--thread-type") && val) {
+            if      (!std::strcmp(val, "auto"))  opts->video_decode.thread_mode = VIDEO_THREADS_AUTO;
+            else if (!std::strcmp(val, "frame")) opts->video_decode.thread_mode = VIDEO_THREADS_FRAME;
+            else if (!std::strcmp(val, "slice")) opts->video_decode.thread_mode = VIDEO_THREADS_SLICE;
+            else return false;
+            ++i;
+        } else if (!std::strcmp(a, "--convert-threads") && val) {
+            if (!std::strcmp(val, "auto")) opts->video_decode.convert_threads = 0;
+            else {
+                int n = std::atoi(val);
+                if (n < 1) return false;
+                opts->video_decode.convert_threads = n;
+            }
+            ++i;
+        } else if (!std::strcmp(a, "--seeks") && val) {
+            opts->seeks = std::atoi(val);
+            if (opts->seeks < 1) return false;
+            ++i;
+        } else if (!std::strcmp(a, "--trace") && val) {
+            opts->trace_path = val;
+            ++i;
+        } else if (!std::strcmp(a, "--size") && val) {
+            if (std::sscanf(val, "%dx%d", &opts->out_w, &opts->out_h) != 2 ||
+                opts->out_w < 1 || opts->out_h < 1) return false;
+            opts->video_decode.scale_to_display = true;
+            ++i;
+        } else if (!std::strcmp(a, "--frame-pool") && val) {
+            if      (!std::strcmp(val, "auto")) opts->video_decode.frame_pool = 0;
+            else if (!std::strcmp(val, "off"))  opts->video_decode.frame_pool = -1;
+            else {
+                int n = std::atoi(val);
+                if (n < 1) return false;
+                opts->video_decode.frame_pool = n;
+            }
+            ++i;
+        } else if (!std::strcmp(a, "--swscale")) {
+            opts->video_decode.simd_convert = false;
+        } else if (!std::strcmp(a, "--no-video")) {
+            opts->video = false;
+        } else if (!std::strcmp(a, "--no-audio")) {
+            opts->audio = false;
+        } else if (a[0] == '-' && a[1] == '-') {
+            return false;
+        } else {
+            opts->path = a;
+        }
+    }
+    return !opts->path.empty() && (opts->video || opts->audio);
+}
+
+// Peak resident set size (MiB)
+static double peak_rss_mib() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0.0;
+    return pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0.0;
+#ifdef __APPLE__
+    return ru.ru_maxrss / (1024.0 * 1024.0); // byte
+#else
+    return ru.ru_maxrss / 1024.0;            // KiB
+#endif
+#endif
+}
+
+// Dosya boyunca eşit aralıklı seek'ler: her biri için seek + ilk karenin
+// dönmesine kadar geçen süre ve gelen karenin hedefe uzaklığı.
+static void run_seek_bench(DemuxerState* dmx, VideoReaderState* vr, int seeks) {
+    const double dur = video_reader_get_duration_sec(vr);
+    const double start = dmx->fmt->start_time != AV_NOPTS_VALUE
+                         ? dmx->fmt->start_time / (double)AV_TIME_BASE : 0.0;
+    const double tb = vr->time_base.num / (double)vr->time_base.den;
+    if (dur <= 0.0) { std::printf("seek bench: unknown duration\n"); return; }
+    AVFrame* frame = av_frame_alloc();
+
+    for (int mode = 0; mode < 2; ++mode) {
+        vr->accurate_seek = (mode == 1);
+        double sum_ms = 0.0, max_ms = 0.0, sum_err = 0.0, max_err = 0.0;
+        int64_t dropped = 0;
+        int done = 0;
+        for (int i = 0; i < seeks; ++i) {
+            const double target = start + dur * (i + 0.5) / seeks;
+            const double t0 = stage_clock_now();
+            int64_t pts = 0;
+            if (!demuxer_seek(dmx, target)) continue;
+            // decoder'da seek öncesinden kalan kareler yeni serial'a kadar atlanır
+            bool ok;
+            do ok = video_reader_read_frame(vr, frame, &pts);
+            while (ok && vr->serial != packet_queue_serial(vr->pkt_queue));
+            if (!ok) continue;
+            const double ms = (stage_clock_now() - t0) * 1e3;
+            const double err = std::fabs(pts * tb - target);
+            sum_ms += ms; sum_err += err; ++done;
+            if (ms > max_ms) max_ms = ms;
+            if (err > max_err) max_err = err;
+            if (vr->accurate_seek) dropped += vr->stat_seek_dropped;
+        }
+        if (!done) continue;
+        std::printf("  %-9s %3d seeks  avg %7.1f ms  max %7.1f ms  |pts-target| avg %6.1f ms max %6.1f ms",
+                    mode ? "accurate" : "fast", done, sum_ms / done, max_ms,
+                    sum_err / done * 1e3, max_err * 1e3);
+        if (mode) std::printf("  %.1f frames decoded forward/seek", dropped / (double)done);
+        std::printf("\n");
+    }
+    av_frame_free(&frame);
+}
+
+int main(int argc, const char** argv) {
+    BenchOptions opts;
+    if (!parse_args(argc, argv, &opts)) { print_usage(argv[0]); return 1; }
+    stage_trace_thread_name("bench");
+    if (!opts.trace_path.empty()) stage_trace_enable(true);
+
+    const double t_open = stage_clock_now();
+    DemuxerState dmx;
+    dmx.build_index = false; // sadece decode hattını ölç
+    if (!demuxer_open(&dmx, opts.path.c_str())) return 1;
+
+    VideoReaderState vr{};
+    SoundReaderState sr;
+    bool have_video = opts.video && dmx.video_stream_index >= 0;
+    bool have_audio = opts.audio && dmx.audio_stream_index >= 0 && opts.seeks == 0;
+    if (have_video && !video_reader_open(&vr, &dmx, opts.video_decode)) { demuxer_close(&dmx); return 1; }
+    if (have_video && opts.out_w > 0) video_reader_set_output_size(&vr, opts.out_w, opts.out_h);
+    if (have_audio && !sound_reader_open(&sr, &dmx, 48000, 2, AV_SAMPLE_FMT_S16)) have_audio = false;
+    if (!have_video && !have_audio) {
+        std::printf("nothing to decode\n");
+        if (opts.video && dmx.video_stream_index >= 0) video_reader_close(&vr);
+        demuxer_close(&dmx);
+        return 1;
+    }
+    const double open_sec = stage_clock_now() - t_open;
+
+    const double t0 = stage_clock_now();
+    demuxer_start(&dmx);
+
+    if (opts.seeks > 0) {
+        if (have_video) {
+            std::printf("\n%s\n", opts.path.c_str());
+            run_seek_bench(&dmx, &vr, opts.seeks);
+        }
+        demuxer_stop(&dmx);
+        if (!opts.trace_path.empty()) stage_trace_write_json(opts.trace_path.c_str());
+        if (have_video) video_reader_close(&vr);
+        demuxer_close(&dmx);
+        return 0;
+    }
+
+    // Ses ayrı thread'de: demuxer iki kuyruğu da doldurduğundan, tek thread'de
+    // sırayla tüketmek kuyruklardan birinin dolup okumayı durdurmasına yol açar.
+    int64_t audio_samples = 0;
+    double  audio_sec = 0.0;
+    std::thread audio_thread;
+    if (have_audio) {
+        audio_thread = std::thread([&] {
+            const uint8_t* data = nullptr;
+            int nbytes = 0;
+            double ps = 0.0, pe = 0.0;
+            while (sound_reader_read(&sr, &data, &nbytes, &ps, &pe))
+                audio_samples += nbytes / sr.bytes_per_frame;
+            audio_sec = stage_clock_now() - t0;
+        });
+    }
+
+    int64_t video_frames = 0;
+    double  video_sec = 0.0;
+    const int64_t POOL_WARMUP_FRAMES = 100;
+    int64_t pool_warm_allocs = -1;
+    if (have_video) {
+        std::vector<uint8_t> rgb((size_t)vr.out_width * vr.out_height * 4);
+        AVFrame* frame = av_frame_alloc();
+        int64_t pts = 0;
+        while (video_reader_read_frame(&vr, frame, &pts)) {
+            video_reader_convert(&vr, frame, rgb.data(), vr.out_width * 4);
+            // ısınma: decoder referans kareleri ve thread'leri dolana kadar
+            if (++video_frames == POOL_WARMUP_FRAMES)
+                pool_warm_allocs = decoder_frame_pool_stats(&vr.frame_pool).allocations;
+        }
+        av_frame_free(&frame);
+        video_sec = stage_clock_now() - t0;
+    }
+    if (audio_thread.joinable()) audio_thread.join();
+    const double wall = stage_clock_now() - t0;
+
+    demuxer_stop(&dmx);
+
+    std::printf("\n%s\n", opts.path.c_str());
+    std::printf("  open/probe       %9.1f ms\n", open_sec * 1e3);
+    std::printf("  wall             %9.1f ms\n", wall * 1e3);
+    std::printf("  demux            %9.1f ms  (av_read_frame)\n", dmx.stat_read_sec * 1e3);
+    if (have_video) {
+        const double n = video_frames > 0 ? (double)video_frames : 1.0;
+        std::printf("  video            %9lld frames  %8.1f fps  (%dx%d)\n", (long long)video_frames,
+                    video_sec > 0 ? video_frames / video_sec : 0.0, vr.width, vr.height);
+        std::printf("    decode         %9.1f ms  %7.3f ms/frame  (%s, %d thread(s), %s threading)\n",
+                    vr.stat_decode_sec * 1e3, vr.stat_decode_sec * 1e3 / n, vr.av_codec_ctx->codec->name,
+                    vr.av_codec_ctx->thread_count, video_reader_threading(&vr));
+        std::printf("    convert        %9.1f ms  %7.3f ms/frame  (%dx%d, %s, %d thread(s))\n",
+                    vr.stat_scale_sec * 1e3, vr.stat_scale_sec * 1e3 / n, vr.out_width, vr.out_height,
+                    vr.convert_kernel ? vr.convert_kernel : "-",
+                    vr.out_width == vr.width && vr.out_height == vr.height ? vr.convert_threads : 1);
+        const FramePoolStats ps = decoder_frame_pool_stats(&vr.frame_pool);
+        std::printf("    frame pool     %9d buffers   peak in use %d / %d, %lld allocations, %lld fallbacks",
+                    ps.allocated, ps.peak_in_use, ps.capacity, (long long)ps.allocations,
+                    (long long)ps.fallbacks);
+        if (pool_warm_allocs >= 0)
+            std::printf(", %lld after frame %lld", (long long)(ps.allocations - pool_warm_allocs),
+                        (long long)POOL_WARMUP_FRAMES);
+        std::printf("\n");
+    }
+    if (have_audio) {
+        std::printf("  audio            %9lld samples  %8.2f Msamples/s  (%.1f s of audio)\n",
+                    (long long)audio_samples, audio_sec > 0 ? audio_samples / audio_sec / 1e6 : 0.0,
+                    audio_samples / (double)sr.dst_sample_rate);
+        std::printf("    decode         %9.1f ms\n", sr.stat_decode_sec * 1e3);
+        std::printf("    swr_convert    %9.1f ms\n", sr.stat_resample_sec * 1e3);
+    }
+    std::printf("  peak RSS         %9.1f MiB\n", peak_rss_mib());
+    if (!opts.trace_path.empty()) stage_trace_write_json(opts.trace_path.c_str());
+
+    if (have_video) video_reader_close(&vr);
+    if (have_audio) sound_reader_close(&sr);
+    demuxer_close(&dmx);
+    return 0;
+}
@@ -0,0 +1,193 @@
+// yuv_bench.cpp
+// yuv_convert kernel'lerinin doğruluğu ve hızı:
+//  - her kernel scalar ile bit-exact mi, çift hassasiyetli referansa en fazla 1 LSB mi
+//  - swscale (reader'ın eski yolu, aynı matris/aralık ayarlı) ile fark
+//  - 4K kare başına süre: kernel'ler ve swscale
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+#include "yuv_convert.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const AVPixelFormat FORMATS[] = { AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12, AV_PIX_FMT_YUV420P10LE };
+static const YuvKernel     KERNELS[] = { YUV_KERNEL_SCALAR, YUV_KERNEL_SSE4, YUV_KERNEL_AVX2 };
+
+static int sample(const AVFrame* f, int plane, int x, int y) {
+    const uint8_t* row = f->data[plane] + (ptrdiff_t)y * f->linesize[plane];
+    return f->format == AV_PIX_FMT_YUV420P10LE ? ((const uint16_t*)row)[x] : row[x];
+}
+
+static void put(AVFrame* f, int plane, int x, int y, int v) {
+    uint8_t* row = f->data[plane] + (ptrdiff_t)y * f->linesize[plane];
+    if (f->format == AV_PIX_FMT_YUV420P10LE) ((uint16_t*)row)[x] = (uint16_t)v;
+    else row[x] = (uint8_t)v;
+}
+
+// Yumuşak içerik (swscale chroma'yı enterpole edebilir; gürültüde karşılaştırma anlamsız)
+// + birkaç doygun blok ve aralık dışı değer (clamp yolu)
+static AVFrame* make_frame(AVPixelFormat fmt, int w, int h) {
+    AVFrame* f = av_frame_alloc();
+    f->format = fmt; f->width = w; f->height = h;
+    if (av_frame_get_buffer(f, 64) < 0) { av_frame_free(&f); return nullptr; }
+    const int max = fmt == AV_PIX_FMT_YUV420P10LE ? 1023 : 255;
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x) {
+            double v = 0.5 + 0.45 * std::sin(x * 0.01) * std::cos(y * 0.013) + 0.05 * std::sin((x + y) * 0.2);
+            put(f, 0, x, y, (int)std::lround(std::min(1.0, std::max(0.0, v)) * max));
+        }
+    const int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    for (int y = 0; y < ch; ++y)
+        for (int x = 0; x < cw; ++x) {
+            int u = (int)std::lround((0.5 + 0.4 * std::sin(x * 0.021 + y * 0.007)) * max);
+            int v = (int)std::lround((0.5 + 0.4 * std::cos(y * 0.017 - x * 0.005)) * max);
+            if (fmt == AV_PIX_FMT_NV12) { put(f, 1, 2 * x, y, u); put(f, 1, 2 * x + 1, y, v); }
+            else                        { put(f, 1, x, y, u);     put(f, 2, x, y, v); }
+        }
+    return f;
+}
+
+// Çift hassasiyetli referans (nearest chroma)
+static int max_ref_diff(const AVFrame* f, const uint8_t* rgba, YuvMatrix m, bool full) {
+    const int depth = f->format == AV_PIX_FMT_YUV420P10LE ? 10 : 8;
+    const double kr = m == YUV_BT709 ? 0.2126 : 0.299, kb = m == YUV_BT709 ? 0.0722 : 0.114;
+    const double kg = 1.0 - kr - kb, sc = 1 << (depth - 8), maxc = (1 << depth) - 1;
+    const double ky = full ? 255.0 / maxc : 255.0 / (219.0 * sc);
+    const double kc = full ? 255.0 / maxc : 255.0 / (224.0 * sc);
+    const bool nv12 = f->format == AV_PIX_FMT_NV12;
+    int worst = 0;
+    for (int y = 0; y < f->height; ++y)
+        for (int x = 0; x < f->width; ++x) {
+            double Y = (sample(f, 0, x, y) - (full ? 0 : 16 * sc)) * ky;
+            double U = ((nv12 ? sample(f, 1, x & ~1, y / 2) : sample(f, 1, x / 2, y / 2)) - (1 << (depth - 1))) * kc;
+            double V = ((nv12 ? sample(f, 1, x | 1, y / 2)  : sample(f, 2, x / 2, y / 2)) - (1 << (depth - 1))) * kc;
+            double ref[3] = { Y + 2 * (1 - kr) * V, Y - 2 * kb * (1 - kb) / kg * U - 2 * kr * (1 - kr) / kg * V,
+                              Y + 2 * (1 - kb) * U };
+            const uint8_t* px = rgba + ((size_t)y * f->width + x) * 4;
+            for (int c = 0; c < 3; ++c) {
+                int e = (int)std::lround(std::min(255.0, std::max(0.0, ref[c])));
+                worst = std::max(worst, std::abs(e - px[c]));
+            }
+            if (px[3] != 255) worst = 255;
+        }
+    return worst;
+}
+
+static SwsContext* make_sws(const AVFrame* f, YuvMatrix m, bool full) {
+    SwsContext* ctx = sws_getContext(f->width, f->height, (AVPixelFormat)f->format, f->width, f->height,
+                                     AV_PIX_FMT_RGBA, SWS_BILINEAR, NULL, NULL, NULL);
+    if (ctx) {
+        const int cs = m == YUV_BT709 ? SWS_CS_ITU709 : SWS_CS_ITU601;
+        sws_setColorspaceDetails(ctx, sws_getCoefficients(cs), full ? 1 : 0,
+                                 sws_getCoefficients(SWS_CS_DEFAULT), 1, 0, 1 << 16, 1 << 16);
+    }
+    return ctx;
+}
+
+static void sws_convert(SwsContext* ctx, const AVFrame* f, uint8_t* rgba) {
+    uint8_t* dst[4] = { rgba, NULL, NULL, NULL };
+    int dst_stride[4] = { f->width * 4, 0, 0, 0 };
+    sws_scale(ctx, f->data, f->linesize, 0, f->height, dst, dst_stride);
+}
+
+static double now_sec() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool check(AVPixelFormat fmt, int w, int h) {
+    AVFrame* f = make_frame(fmt, w, h);
+    if (!f) { std::printf("frame alloc failed\n"); return false; }
+    std::vector<uint8_t> ref((size_t)w * h * 4), out((size_t)w * h * 4), sws((size_t)w * h * 4);
+    bool ok = true;
+    for (int m = 0; m < 2; ++m)
+        for (int full = 0; full < 2; ++full) {
+            YuvConverter cv;
+            yuv_converter_init(&cv, fmt, (YuvMatrix)m, full != 0, YUV_KERNEL_SCALAR);
+            yuv_converter_run(&cv, f, ref.data(), w * 4, 0, h);
+            const int ref_diff = max_ref_diff(f, ref.data(), (YuvMatrix)m, full != 0);
+
+            bool exact = true;
+            for (YuvKernel k : KERNELS) {
+                if (k == YUV_KERNEL_SCALAR || !yuv_kernel_supported(k)) continue;
+                yuv_converter_init(&cv, fmt, (YuvMatrix)m, full != 0, k);
+                yuv_converter_run(&cv, f, out.data(), w * 4, 0, h);
+                if (out != ref) exact = false;
+            }
+
+            int sws_max = -1; double sws_mean = 0.0;
+            if (SwsContext* ctx = make_sws(f, (YuvMatrix)m, full != 0)) {
+                sws_convert(ctx, f, sws.data());
+                sws_freeContext(ctx);
+                double sum = 0.0; sws_max = 0;
+                for (size_t i = 0; i < ref.size(); i += 4)
+                    for (int c = 0; c < 3; ++c) {
+                        int d = std::abs(ref[i + c] - sws[i + c]);
+                        sum += d; sws_max = std::max(sws_max, d);
+                    }
+                sws_mean = sum / ((double)w * h * 3);
+            }
+            // swscale'in 8-bit tablo yolu ve (p10'da) chroma enterpolasyonu birkaç LSB fark yaratır
+            const bool pass = ref_diff <= 1 && exact && sws_max <= 6 && sws_mean <= 1.5;
+            ok = ok && pass;
+            std::printf("  %-12s %4dx%-4d %s %-7s  ref max %d  kernels %s  swscale max %d mean %.2f  %s\n",
+                        av_get_pix_fmt_name(fmt), w, h, m ? "BT.709" : "BT.601", full ? "full" : "limited",
+                        ref_diff, exact ? "bit-exact" : "DIFFER", sws_max, sws_mean, pass ? "ok" : "FAIL");
+        }
+    av_frame_free(&f);
+    return ok;
+}
+
+static void throughput(AVPixelFormat fmt, int w, int h, int iters) {
+    AVFrame* f = make_frame(fmt, w, h);
+    if (!f) return;
+    std::vector<uint8_t> out((size_t)w * h * 4);
+    const double mpix = (double)w * h * iters / 1e6;
+
+    double t_sws = 0.0;
+    if (SwsContext* ctx = make_sws(f, YUV_BT709, false)) {
+        sws_convert(ctx, f, out.data());
+        double t0 = now_sec();
+        for (int i = 0; i < iters; ++i) sws_convert(ctx, f, out.data());
+        t_sws = now_sec() - t0;
+        sws_freeContext(ctx);
+        std::printf("  %-12s %-8s %7.2f ms/frame  %8.1f Mpix/s\n", av_get_pix_fmt_name(fmt), "swscale",
+                    t_sws * 1e3 / iters, mpix / t_sws);
+    }
+    for (YuvKernel k : KERNELS) {
+        if (!yuv_kernel_supported(k)) continue;
+        YuvConverter cv;
+        yuv_converter_init(&cv, fmt, YUV_BT709, false, k);
+        double t0 = now_sec();
+        for (int i = 0; i < iters; ++i) yuv_converter_run(&cv, f, out.data(), w * 4, 0, h);
+        double t = now_sec() - t0;
+        std::printf("  %-12s %-8s %7.2f ms/frame  %8.1f Mpix/s", av_get_pix_fmt_name(fmt),
+                    yuv_kernel_name(k), t * 1e3 / iters, mpix / t);
+        if (t_sws > 0.0) std::printf("  x%.2f vs swscale", t_sws / t);
+        std::printf("\n");
+    }
+    av_frame_free(&f);
+}
+
+int main(int argc, char** argv) {
+    const int iters = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+
+    std::printf("correctness (single thread)\n");
+    bool ok = true;
+    for (AVPixelFormat fmt : FORMATS) {
+        ok = check(fmt, 1920, 1080) && ok;
+        ok = check(fmt, 1917, 1081) && ok; // tek genişlik/yükseklik: kuyruk ve son chroma satırı
+    }
+
+    std::printf("\nthroughput 3840x2160, %d frames, single thread\n", iters);
+    for (AVPixelFormat fmt : FORMATS) throughput(fmt, 3840, 2160, iters);
+    std::printf("dispatch: %s\n", yuv_kernel_name(yuv_best_kernel()));
+    return ok ? 0 : 1;
+}
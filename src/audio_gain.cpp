@@ -0,0 +1,125 @@
+#include "audio_gain.hpp"
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AUDIO_GAIN_X86 1
+#include <immintrin.h>
+#endif
+
+// Kernels take the gain as an accumulator in Q15 << 16; every
+// AUDIO_GAIN_BLOCK samples use (acc >> 16) and then add `step`.
+typedef void (*gain_fn)(int16_t* p, int count, int32_t acc, int32_t step);
+
+static void gain_scalar(int16_t* p, int count, int32_t acc, int32_t step) {
+    for (int i = 0; i < count; i += AUDIO_GAIN_BLOCK) {
+        const int32_t g = acc >> 16;
+        const int n = (count - i < AUDIO_GAIN_BLOCK) ? count - i : AUDIO_GAIN_BLOCK;
+        for (int j = 0; j < n; ++j) {
+            int32_t v = (p[i + j] * g + 0x4000) >> 15;
+            if (v >  32767) v =  32767;
+            if (v < -32768) v = -32768;
+            p[i + j] = (int16_t)v;
+        }
+        acc += step;
+    }
+}
+
+#ifdef AUDIO_GAIN_X86
+__attribute__((target("sse2")))
+static void gain_sse2(int16_t* p, int count, int32_t acc, int32_t step) {
+    const __m128i round = _mm_set1_epi32(0x4000);
+    int i = 0;
+    for (; i + AUDIO_GAIN_BLOCK <= count; i += AUDIO_GAIN_BLOCK) {
+        const __m128i g = _mm_set1_epi16((int16_t)(acc >> 16));
+        for (int k = 0; k < AUDIO_GAIN_BLOCK; k += 8) {
+            __m128i x  = _mm_loadu_si128((const __m128i*)(p + i + k));
+            __m128i lo = _mm_mullo_epi16(x, g);
+            __m128i hi = _mm_mulhi_epi16(x, g);
+            __m128i a  = _mm_unpacklo_epi16(lo, hi); // 32-bit products
+            __m128i b  = _mm_unpackhi_epi16(lo, hi);
+            a = _mm_srai_epi32(_mm_add_epi32(a, round), 15);
+            b = _mm_srai_epi32(_mm_add_epi32(b, round), 15);
+            _mm_storeu_si128((__m128i*)(p + i + k), _mm_packs_epi32(a, b)); // saturating
+        }
+        acc += step;
+    }
+    if (i < count) gain_scalar(p + i, count - i, acc, step);
+}
+
+__attribute__((target("avx2")))
+static void gain_avx2(int16_t* p, int count, int32_t acc, int32_t step) {
+    const __m256i round = _mm256_set1_epi32(0x4000);
+    int i = 0;
+    for (; i + AUDIO_GAIN_BLOCK <= count; i += AUDIO_GAIN_BLOCK) {
+        const __m256i g = _mm256_set1_epi16((int16_t)(acc >> 16));
+        __m256i x  = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i lo = _mm256_mullo_epi16(x, g);
+        __m256i hi = _mm256_mulhi_epi16(x, g);
+        // unpack/pack work per 128-bit lane, so sample order is preserved
+        __m256i a  = _mm256_unpacklo_epi16(lo, hi);
+        __m256i b  = _mm256_unpackhi_epi16(lo, hi);
+        a = _mm256_srai_epi32(_mm256_add_epi32(a, round), 15);
+        b = _mm256_srai_epi32(_mm256_add_epi32(b, round), 15);
+        _mm256_storeu_si256((__m256i*)(p + i), _mm256_packs_epi32(a, b));
+        acc += step;
+    }
+    if (i < count) gain_scalar(p + i, count - i, acc, step);
+}
+#endif
+
+static gain_fn kernel_fn(AudioGainKernel k) {
+#ifdef AUDIO_GAIN_X86
+    if (k == AUDIO_GAIN_AVX2) return gain_avx2;
+    if (k == AUDIO_GAIN_SSE2) return gain_sse2;
+#endif
+    (void)k;
+    return gain_scalar;
+}
+
+bool audio_gain_kernel_supported(AudioGainKernel k) {
+#ifdef AUDIO_GAIN_X86
+    __builtin_cpu_init();
+    if (k == AUDIO_GAIN_AVX2) return __builtin_cpu_supports("avx2");
+    if (k == AUDIO_GAIN_SSE2) return __builtin_cpu_supports("sse2");
+#endif
+    return k == AUDIO_GAIN_SCALAR;
+}
+
+AudioGainKernel audio_gain_best_kernel() {
+    static const AudioGainKernel best =
+        audio_gain_kernel_supported(AUDIO_GAIN_AVX2) ? AUDIO_GAIN_AVX2 :
+        audio_gain_kernel_supported(AUDIO_GAIN_SSE2) ? AUDIO_GAIN_SSE2 : AUDIO_GAIN_SCALAR;
+    return best;
+}
+
+const char* audio_gain_kernel_name(AudioGainKernel k) {
+    switch (k) {
+        case AUDIO_GAIN_AVX2: return "avx2";
+        case AUDIO_GAIN_SSE2: return "sse2";
+        default:              return "scalar";
+    }
+}
+
+static inline int32_t gain_to_q15(float g) {
+    if (!(g > 0.f)) return 0;
+    if (g >= 1.f)   return 32767; // Q15 üst sınırı (-0.0003 dB)
+    long q = std::lround(g * 32768.f);
+    return (int32_t)(q > 32767 ? 32767 : q);
+}
+
+void audio_gain_s16_kernel(AudioGainKernel k, int16_t* samples, int count,
+                           float gain_from, float gain_to) {
+    if (!samples || count <= 0) return;
+    if (gain_from >= 1.f && gain_to >= 1.f) return; // unity: dokunma
+    if (!audio_gain_kernel_supported(k)) k = AUDIO_GAIN_SCALAR;
+
+    const int32_t g0 = gain_to_q15(gain_from);
+    const int32_t g1 = gain_to_q15(gain_to);
+    const int nblocks = (count + AUDIO_GAIN_BLOCK - 1) / AUDIO_GAIN_BLOCK;
+    const int32_t step = (nblocks > 1) ? (int32_t)((int64_t)(g1 - g0) * 65536 / (nblocks - 1)) : 0;
+    kernel_fn(k)(samples, count, g0 << 16, step);
+}
+
+void audio_gain_s16(int16_t* samples, int count, float gain_from, float gain_to) {
+    audio_gain_s16_kernel(audio_gain_best_kernel(), samples, count, gain_from, gain_to);
+}
@@ -0,0 +1,27 @@
+#ifndef audio_gain_hpp
+#define audio_gain_hpp
+
+#include <cstdint>
+
+// S16 gain stage: Q15 fixed-point multiply with rounding and saturation.
+// The gain ramps linearly from `gain_from` to `gain_to` across the buffer
+// (stepped every AUDIO_GAIN_BLOCK samples) so volume changes do not click.
+// Every kernel produces bit-identical output.
+enum AudioGainKernel {
+    AUDIO_GAIN_SCALAR,
+    AUDIO_GAIN_SSE2,
+    AUDIO_GAIN_AVX2,
+};
+
+static const int AUDIO_GAIN_BLOCK = 16;
+
+// Runtime CPU dispatch (resolved once).
+AudioGainKernel audio_gain_best_kernel();
+bool            audio_gain_kernel_supported(AudioGainKernel k);
+const char*     audio_gain_kernel_name(AudioGainKernel k);
+
+void audio_gain_s16(int16_t* samples, int count, float gain_from, float gain_to);
+void audio_gain_s16_kernel(AudioGainKernel k, int16_t* samples, int count,
+                           float gain_from, float gain_to);
+
+#endif
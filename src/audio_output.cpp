@@ -0,0 +1,211 @@
+#include "audio_output.hpp"
+#include "audio_gain.hpp"
+#include "stage_trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Saat anlık görüntüsünün yazıcı tarafı (seqlock). Yazıcılar birbirini
+// dışlar: callback ya da cihaz kilidini tutan audio thread'i.
+static void clock_write_begin(AudioOutputState* st) {
+    st->clock_seq.store(st->clock_seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void clock_write_end(AudioOutputState* st) {
+    st->clock_seq.store(st->clock_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// SDL audio thread: sadece ring'den okur ve atomik sayaç yayınlar (kilit yok).
+// Ses seviyesi burada uygulanır: değişiklik bir cihaz periyodunda duyulur,
+// ring'deki ~300ms tamponu atıp yeniden decode etmek gerekmez.
+static void audio_callback(void* userdata, Uint8* stream, int len) {
+    auto* st = (AudioOutputState*)userdata;
+    size_t got = audio_ring_read(&st->ring, stream, (size_t)len);
+    if (got < (size_t)len) std::memset(stream + got, 0, (size_t)len - got); // underrun: sessizlik
+
+    // önceki kazançtan yeniye periyot boyunca rampa (tıklama olmasın)
+    const float vol = st->volume.load(std::memory_order_relaxed);
+    audio_gain_s16((int16_t*)stream, (int)(got / 2), st->applied_volume, vol);
+    st->applied_volume = vol;
+    const int frames = (int)(got / st->bytes_per_frame);
+    const double now = stage_clock_now();
+    clock_write_begin(st);
+    st->cb_time.store(now, std::memory_order_relaxed);
+    st->cb_frames.store(frames, std::memory_order_relaxed);
+    st->played_frames.store(st->played_frames.load(std::memory_order_relaxed) + frames,
+                            std::memory_order_relaxed);
+    clock_write_end(st);
+}
+
+static void audio_loop(AudioOutputState* st) {
+    stage_trace_thread_name("audio decode");
+    // Decode edilmiş ama ring'de yer bekleyen frame (reader içinde durur)
+    bool pending = false; int pending_max = 0; double pending_pts = 0.0;
+    bool dropping = false; double drop_until = 0.0; // accurate seek: bundan önce biten frame'ler atılır
+
+    std::unique_lock<std::mutex> lock(st->mtx);
+    while (!st->quit) {
+        if (st->flush_req) {
+            pending = false;
+            SDL_LockAudioDevice(st->dev); // callback bu sırada çalışmaz
+            audio_ring_reset(&st->ring);
+            clock_write_begin(st);
+            st->played_frames.store(0, std::memory_order_relaxed);
+            st->cb_frames.store(0, std::memory_order_relaxed);
+            st->base_pts.store(st->flush_pts, std::memory_order_relaxed);
+            st->clock_epoch.store(st->clock_epoch.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+            clock_write_end(st);
+            SDL_UnlockAudioDevice(st->dev);
+            st->have_base = false;
+            st->eof = false;
+            dropping = st->flush_accurate;
+            drop_until = st->flush_pts;
+            st->flush_req = false;
+            st->cv.notify_all();
+            continue;
+        }
+
+        if (pending) {
+            if (audio_ring_available(&st->ring) >= st->target_bytes ||
+                audio_ring_space(&st->ring) < (size_t)pending_max) {
+                st->cv.wait_for(lock, std::chrono::milliseconds(5));
+                continue;
+            }
+            // swr doğrudan ring'e yazar: ara buffer, kopya ve allocation yok
+            uint8_t* p0; uint8_t* p1; size_t n0, n1;
+            audio_ring_write_regions(&st->ring, (size_t)pending_max, &p0, &n0, &p1, &n1);
+            int nbytes = sound_reader_convert(st->reader, p0, (int)n0, p1, (int)n1);
+            pending = false;
+            if (nbytes <= 0) continue;
+
+            // ilk örnek yayınlanmadan önce saat tabanı (callback henüz bir şey saymadı)
+            if (!st->have_base) {
+                SDL_LockAudioDevice(st->dev); // tek yazıcı: callback beklesin
+                clock_write_begin(st);
+                st->base_pts.store(pending_pts, std::memory_order_relaxed);
+                st->clock_epoch.store(st->clock_epoch.load(std::memory_order_relaxed) + 1,
+                                      std::memory_order_relaxed);
+                clock_write_end(st);
+                SDL_UnlockAudioDevice(st->dev);
+                st->have_base = true;
+            }
+            audio_ring_commit(&st->ring, (size_t)nbytes);
+            st->cv.notify_all();
+            continue;
+        }
+
+        if (st->eof) {
+            st->cv.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        lock.unlock();
+        double a_start = 0.0, a_end = 0.0;
+        int max_bytes = sound_reader_decode(st->reader, &a_start, &a_end);
+        lock.lock();
+
+        if (max_bytes < 0) { st->eof = true; st->cv.notify_all(); continue; }
+        if (st->reader->serial != packet_queue_serial(st->reader->pkt_queue)) continue; // seek öncesi paketten
+        if (dropping && a_end <= drop_until) continue; // keyframe ile hedef arası (bir sonraki decode bırakır)
+        dropping = false;
+        pending = true; pending_max = max_bytes; pending_pts = a_start;
+    }
+}
+
+bool audio_output_open(AudioOutputState* st, SoundReaderState* reader, double buffer_sec) {
+    st->reader          = reader;
+    st->sample_rate     = reader->dst_sample_rate;
+    st->channels        = reader->dst_channels;
+    st->bytes_per_frame = st->channels * av_get_bytes_per_sample(reader->dst_fmt);
+    st->target_bytes    = (size_t)(buffer_sec * st->sample_rate) * st->bytes_per_frame;
+
+    SDL_AudioSpec want{}; want.freq = st->sample_rate; want.channels = (Uint8)st->channels;
+    want.format = AUDIO_S16SYS; want.samples = 1024;
+    want.callback = audio_callback; want.userdata = st;
+    SDL_AudioSpec have{};
+    st->dev = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
+    if (!st->dev) {
+        std::printf("SDL_OpenAudioDevice failed: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // hedef + en büyük decode edilmiş parça için pay
+    audio_ring_init(&st->ring, st->target_bytes * 2 + 64 * 1024, (size_t)st->bytes_per_frame);
+    st->played_frames.store(0);
+    st->base_pts.store(0.0);
+    st->cb_frames.store(0);
+    st->last_epoch = ~0u;
+    st->eof = false; st->quit = false; st->flush_req = false; st->have_base = false;
+    st->thread = std::thread(audio_loop, st);
+    return true;
+}
+
+void audio_output_prebuffer(AudioOutputState* st) {
+    std::unique_lock<std::mutex> lock(st->mtx);
+    st->cv.wait(lock, [st] {
+        return st->quit || st->eof || (!st->flush_req && audio_ring_available(&st->ring) >= st->target_bytes);
+    });
+}
+
+void audio_output_pause(AudioOutputState* st, bool paused) {
+    SDL_PauseAudioDevice(st->dev, paused ? 1 : 0);
+}
+
+void audio_output_flush(AudioOutputState* st, double target_sec, bool accurate) {
+    std::unique_lock<std::mutex> lock(st->mtx);
+    st->flush_pts = target_sec;
+    st->flush_accurate = accurate;
+    st->flush_req = true;
+    st->cv.notify_all();
+    st->cv.wait(lock, [st] { return !st->flush_req || st->quit; });
+}
+
+double audio_output_played_sec(const AudioOutputState* st) {
+    return (double)st->played_frames.load(std::memory_order_acquire) / (double)st->sample_rate;
+}
+
+double audio_output_clock(const AudioOutputState* st) {
+    // Tutarlı anlık görüntü: yazıcı araya girdiyse yeniden oku
+    int64_t played; int frames; double base, cb_time; uint32_t epoch, seq;
+    for (;;) {
+        seq = st->clock_seq.load(std::memory_order_acquire);
+        if (seq & 1) continue;
+        played  = st->played_frames.load(std::memory_order_relaxed);
+        frames  = st->cb_frames.load(std::memory_order_relaxed);
+        base    = st->base_pts.load(std::memory_order_relaxed);
+        cb_time = st->cb_time.load(std::memory_order_relaxed);
+        epoch   = st->clock_epoch.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (st->clock_seq.load(std::memory_order_relaxed) == seq) break;
+    }
+    const double rate = (double)st->sample_rate;
+    // Son callback'te verilen parça o andan itibaren çalınıyor sayılır;
+    // parçanın süresi kadar ilerletilir (pause'da orada durur).
+    const double last = frames / rate;
+    double since = stage_clock_now() - cb_time;
+    if (since < 0.0)  since = 0.0;
+    if (since > last) since = last;
+    double clock = base + played / rate - last + since;
+    // Aynı taban içinde geri gitmez (callback aralığı titrediğinde)
+    if (epoch == st->last_epoch && clock < st->last_clock) clock = st->last_clock;
+    st->last_clock = clock;
+    st->last_epoch = epoch;
+    return clock;
+}
+
+size_t audio_output_buffered_bytes(const AudioOutputState* st) {
+    return audio_ring_available(&st->ring);
+}
+
+void audio_output_close(AudioOutputState* st) {
+    {
+        std::lock_guard<std::mutex> lock(st->mtx);
+        st->quit = true;
+    }
+    st->cv.notify_all();
+    if (st->thread.joinable()) st->thread.join();
+    if (st->dev) { SDL_CloseAudioDevice(st->dev); st->dev = 0; }
+    audio_ring_free(&st->ring);
+}
@@ -0,0 +1,71 @@
+#ifndef audio_output_hpp
+#define audio_output_hpp
+
+#include "audio_ring.hpp"
+#include "sound_reader.hpp"
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Audio decode thread -> SPSC ring -> SDL audio callback.
+// The callback publishes how many sample frames it handed to the device,
+// which is the audio master clock (no SDL lock on the read side).
+struct AudioOutputState {
+    // Public
+    int sample_rate = 0, channels = 0, bytes_per_frame = 0;
+    std::atomic<float> volume{1.0f}; // applied in the callback
+
+    // Private
+    SoundReaderState*     reader = nullptr;
+    SDL_AudioDeviceID     dev = 0;
+    AudioRingBuffer       ring;
+    size_t                target_bytes = 0; // producer keeps this much buffered
+    // Clock snapshot: written under clock_seq (seqlock) by the callback, or
+    // with the device locked by flush / first base, so readers never mix two callbacks.
+    std::atomic<uint32_t> clock_seq{0};     // odd while a writer is updating
+    std::atomic<int64_t>  played_frames{0}; // since last flush, written by callback
+    std::atomic<double>   base_pts{0.0};    // pts of played_frames == 0
+    std::atomic<double>   cb_time{0.0};     // stage_clock_now() of the last callback
+    std::atomic<int>      cb_frames{0};     // frames handed over in the last callback
+    std::atomic<uint32_t> clock_epoch{0};   // bumped when base_pts moves (flush, first audio)
+    mutable double        last_clock = 0.0;   // clock reader only: monotonic floor
+    mutable uint32_t      last_epoch = ~0u;   // epoch of last_clock
+    std::atomic<bool>     eof{false};
+    float                 applied_volume = 1.0f; // callback only (gain ramp start)
+
+    bool                    have_base = false; // producer thread only
+    bool                    quit = false, flush_req = false, flush_accurate = false;
+    double                  flush_pts = 0.0;
+    std::mutex              mtx;
+    std::condition_variable cv;
+    std::thread             thread;
+};
+
+// Opens the SDL device (paused) and starts the decode thread.
+bool audio_output_open(AudioOutputState* st, SoundReaderState* reader, double buffer_sec = 0.3);
+void audio_output_close(AudioOutputState* st);
+
+// Waits until the ring holds buffer_sec of audio (or the stream ended).
+void audio_output_prebuffer(AudioOutputState* st);
+void audio_output_pause(AudioOutputState* st, bool paused);
+
+// Call right after demuxer_seek; the clock reads `target_sec` until new audio plays.
+// accurate: audio frames that end before `target_sec` are dropped.
+void audio_output_flush(AudioOutputState* st, double target_sec, bool accurate = false);
+
+// Seconds played since the last flush, and absolute playback position (seconds).
+// The clock is interpolated between callbacks (a callback period is ~21 ms),
+// so it can be used to schedule frame deadlines. It never steps backwards
+// except when the base moves (flush, first audio after a flush); call it
+// from one thread only (the master clock's).
+double audio_output_played_sec(const AudioOutputState* st);
+double audio_output_clock(const AudioOutputState* st);
+
+// Bytes waiting in the ring (for diagnostics).
+size_t audio_output_buffered_bytes(const AudioOutputState* st);
+
+#endif
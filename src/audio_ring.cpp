@@ -0,0 +1,81 @@
+#include "audio_ring.hpp"
+#include <cstring>
+
+bool audio_ring_init(AudioRingBuffer* rb, size_t min_capacity, size_t frame_bytes) {
+    if (frame_bytes < 1) frame_bytes = 1;
+    size_t cap = (min_capacity + frame_bytes - 1) / frame_bytes * frame_bytes;
+    if (cap < frame_bytes) cap = frame_bytes;
+    rb->data = new uint8_t[cap];
+    rb->capacity = cap;
+    rb->write_pos.store(0, std::memory_order_relaxed);
+    rb->read_pos.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void audio_ring_free(AudioRingBuffer* rb) {
+    delete[] rb->data;
+    rb->data = nullptr;
+    rb->capacity = 0;
+}
+
+size_t audio_ring_write(AudioRingBuffer* rb, const uint8_t* src, size_t n) {
+    const size_t w = rb->write_pos.load(std::memory_order_relaxed);
+    const size_t r = rb->read_pos.load(std::memory_order_acquire);
+    const size_t space = rb->capacity - (w - r);
+    if (n > space) n = space;
+
+    const size_t off   = w % rb->capacity;
+    const size_t first = (n < rb->capacity - off) ? n : rb->capacity - off;
+    std::memcpy(rb->data + off, src, first);
+    std::memcpy(rb->data, src + first, n - first);
+
+    rb->write_pos.store(w + n, std::memory_order_release);
+    return n;
+}
+
+size_t audio_ring_write_regions(AudioRingBuffer* rb, size_t n,
+                                uint8_t** p0, size_t* n0, uint8_t** p1, size_t* n1) {
+    const size_t w = rb->write_pos.load(std::memory_order_relaxed);
+    const size_t r = rb->read_pos.load(std::memory_order_acquire);
+    const size_t space = rb->capacity - (w - r);
+    if (n > space) n = space;
+
+    const size_t off = w % rb->capacity;
+    *p0 = rb->data + off;
+    *n0 = (n < rb->capacity - off) ? n : rb->capacity - off;
+    *p1 = rb->data;
+    *n1 = n - *n0;
+    return n;
+}
+
+void audio_ring_commit(AudioRingBuffer* rb, size_t n) {
+    rb->write_pos.store(rb->write_pos.load(std::memory_order_relaxed) + n, std::memory_order_release);
+}
+
+size_t audio_ring_read(AudioRingBuffer* rb, uint8_t* dst, size_t n) {
+    const size_t r = rb->read_pos.load(std::memory_order_relaxed);
+    const size_t w = rb->write_pos.load(std::memory_order_acquire);
+    const size_t avail = w - r;
+    if (n > avail) n = avail;
+
+    const size_t off   = r % rb->capacity;
+    const size_t first = (n < rb->capacity - off) ? n : rb->capacity - off;
+    std::memcpy(dst, rb->data + off, first);
+    std::memcpy(dst + first, rb->data, n - first);
+
+    rb->read_pos.store(r + n, std::memory_order_release);
+    return n;
+}
+
+size_t audio_ring_available(const AudioRingBuffer* rb) {
+    return rb->write_pos.load(std::memory_order_acquire) - rb->read_pos.load(std::memory_order_acquire);
+}
+
+size_t audio_ring_space(const AudioRingBuffer* rb) {
+    return rb->capacity - audio_ring_available(rb);
+}
+
+void audio_ring_reset(AudioRingBuffer* rb) {
+    rb->read_pos.store(0, std::memory_order_relaxed);
+    rb->write_pos.store(0, std::memory_order_relaxed);
+}
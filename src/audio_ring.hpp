@@ -0,0 +1,38 @@
+#ifndef audio_ring_hpp
+#define audio_ring_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer byte ring.
+// Producer: audio decode thread, consumer: SDL audio callback.
+// Positions are monotonic byte counters; capacity is a multiple of the audio
+// frame size so a wrapped write never splits a sample frame.
+struct AudioRingBuffer {
+    uint8_t*            data = nullptr;
+    size_t              capacity = 0;
+    std::atomic<size_t> write_pos{0};
+    std::atomic<size_t> read_pos{0};
+};
+
+bool audio_ring_init(AudioRingBuffer* rb, size_t min_capacity, size_t frame_bytes = 1);
+void audio_ring_free(AudioRingBuffer* rb);
+
+// Producer side: copies up to n bytes, returns bytes written.
+size_t audio_ring_write(AudioRingBuffer* rb, const uint8_t* src, size_t n);
+// Producer side, zero-copy: up to n writable bytes as two regions (the
+// second is non-empty when the range wraps). Publish with audio_ring_commit.
+size_t audio_ring_write_regions(AudioRingBuffer* rb, size_t n,
+                                uint8_t** p0, size_t* n0, uint8_t** p1, size_t* n1);
+void   audio_ring_commit(AudioRingBuffer* rb, size_t n);
+// Consumer side: copies up to n bytes, returns bytes read.
+size_t audio_ring_read(AudioRingBuffer* rb, uint8_t* dst, size_t n);
+
+size_t audio_ring_available(const AudioRingBuffer* rb); // readable bytes
+size_t audio_ring_space(const AudioRingBuffer* rb);     // writable bytes
+
+// Only while neither side is running (e.g. device locked + producer in flush).
+void audio_ring_reset(AudioRingBuffer* rb);
+
+#endif
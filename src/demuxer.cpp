@@ -0,0 +1,332 @@
+extern "C" {
+#include <libavutil/error.h>
+}
+#include "demuxer.hpp"
+#include "stage_trace.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// ffplay ile aynı sınırlar: toplam ~15MB ya da her kuyrukta yeterli paket varsa dur.
+static const size_t MAX_QUEUE_BYTES = 15 * 1024 * 1024;
+static const int    MIN_PACKETS     = 25;
+
+static inline const char* err2str(int e) {
+    static thread_local char buf[AV_ERROR_MAX_STRING_SIZE];
+    av_strerror(e, buf, sizeof(buf));
+    return buf;
+}
+
+// --- PacketQueue ---
+
+static void packet_queue_put(PacketQueue* q, AVPacket* src) {
+    AVPacket* pkt = av_packet_alloc();
+    if (!pkt) { av_packet_unref(src); return; }
+    av_packet_move_ref(pkt, src);
+    {
+        std::lock_guard<std::mutex> lock(q->mtx);
+        q->bytes += pkt->size;
+        q->q.push_back({ pkt, q->serial });
+    }
+    q->cv.notify_one();
+}
+
+// has_start: yeni serial bir seek hedefiyle başlıyor (accurate seek için)
+static void packet_queue_flush(PacketQueue* q, double start_sec, bool has_start = true) {
+    std::lock_guard<std::mutex> lock(q->mtx);
+    for (auto& e : q->q) av_packet_free(&e.pkt);
+    q->q.clear();
+    q->bytes = 0;
+    q->eof = false;
+    q->serial++;
+    q->start_sec = start_sec;
+    q->has_start = has_start;
+}
+
+static void packet_queue_set_eof(PacketQueue* q) {
+    { std::lock_guard<std::mutex> lock(q->mtx); q->eof = true; }
+    q->cv.notify_all();
+}
+
+static void packet_queue_abort(PacketQueue* q) {
+    { std::lock_guard<std::mutex> lock(q->mtx); q->abort = true; }
+    q->cv.notify_all();
+}
+
+int packet_queue_get(PacketQueue* q, AVPacket* pkt, int* serial, bool block) {
+    std::unique_lock<std::mutex> lock(q->mtx);
+    if (block) q->cv.wait(lock, [q] { return q->abort || q->eof || !q->q.empty(); });
+    if (serial) *serial = q->serial;
+    if (q->abort) return -1;
+    if (q->q.empty()) return q->eof ? -1 : 0;
+
+    PacketQueue::Entry e = q->q.front();
+    q->q.pop_front();
+    q->bytes -= e.pkt->size;
+    lock.unlock();
+
+    av_packet_move_ref(pkt, e.pkt);
+    av_packet_free(&e.pkt);
+    if (serial) *serial = e.serial;
+    return 1;
+}
+
+int packet_queue_serial(PacketQueue* q) {
+    std::lock_guard<std::mutex> lock(q->mtx);
+    return q->serial;
+}
+
+bool packet_queue_serial_start(PacketQueue* q, int serial, double* start_sec) {
+    std::lock_guard<std::mutex> lock(q->mtx);
+    if (q->serial != serial || !q->has_start) return false;
+    *start_sec = q->start_sec;
+    return true;
+}
+
+int packet_queue_size(PacketQueue* q) {
+    std::lock_guard<std::mutex> lock(q->mtx);
+    return (int)q->q.size();
+}
+
+static bool queues_full(DemuxerState* st) {
+    size_t bytes = 0;
+    bool enough = true;
+    for (PacketQueue* q : { &st->video_q, &st->audio_q }) {
+        std::lock_guard<std::mutex> lock(q->mtx);
+        if (!q->enabled) continue;
+        bytes += q->bytes;
+        if ((int)q->q.size() < MIN_PACKETS) enough = false;
+    }
+    return bytes > MAX_QUEUE_BYTES || enough;
+}
+
+// --- Demuxer ---
+
+static int seek_stream_index(const DemuxerState* st) {
+    return st->video_stream_index >= 0 ? st->video_stream_index : st->audio_stream_index;
+}
+
+// quick: sidecar indeks var, süre/keyframe'ler oradan geldiği için kısa probe yeter
+static bool open_input(DemuxerState* st, const char* filename, bool quick) {
+    st->fmt = avformat_alloc_context();
+    if (!st->fmt) {
+        std::printf("Couldn't created AVFormatContext\n");
+        return false;
+    }
+    if (quick) {
+        st->fmt->probesize = 512 * 1024;
+        st->fmt->max_analyze_duration = AV_TIME_BASE / 4;
+    }
+    st->video_stream_index = st->audio_stream_index = -1;
+    int err = avformat_open_input(&st->fmt, filename, nullptr, nullptr);
+    if (err < 0) {
+        std::fprintf(stderr, "Couldn't open file '%s': %s\n", filename, err2str(err));
+        return false;
+    }
+    err = avformat_find_stream_info(st->fmt, nullptr);
+    if (err < 0) {
+        std::printf("demux: find_stream_info failed: %s\n", err2str(err));
+        return false;
+    }
+
+    // İlk çözülebilir video ve ses stream'leri
+    for (unsigned i = 0; i < st->fmt->nb_streams; ++i) {
+        auto* params = st->fmt->streams[i]->codecpar;
+        if (!avcodec_find_decoder(params->codec_id)) continue;
+        if (params->codec_type == AVMEDIA_TYPE_VIDEO && st->video_stream_index < 0)
+            st->video_stream_index = (int)i;
+        else if (params->codec_type == AVMEDIA_TYPE_AUDIO && st->audio_stream_index < 0)
+            st->audio_stream_index = (int)i;
+    }
+    if (st->video_stream_index < 0 && st->audio_stream_index < 0) {
+        std::printf("demux: no decodable audio/video stream\n");
+        return false;
+    }
+    return true;
+}
+
+// Kısa probe bazı parametreleri boş bırakabilir (ör. TS'de ses); o zaman tam probe
+static bool stream_params_complete(const DemuxerState* st) {
+    if (st->video_stream_index >= 0) {
+        const AVCodecParameters* p = st->fmt->streams[st->video_stream_index]->codecpar;
+        if (p->width <= 0 || p->height <= 0) return false;
+    }
+    if (st->audio_stream_index >= 0) {
+        const AVCodecParameters* p = st->fmt->streams[st->audio_stream_index]->codecpar;
+        if (p->sample_rate <= 0) return false;
+    }
+    return true;
+}
+
+bool demuxer_open(DemuxerState* st, const char* filename) {
+    st->path = filename;
+    bool cached = keyframe_index_load(&st->index, filename);
+    if (cached) {
+        if (open_input(st, filename, true) && stream_params_complete(st) &&
+            keyframe_index_matches(&st->index, st->fmt, seek_stream_index(st))) {
+            // İndeksin ölçtüğü kesin süre (TS'de format süresi bitrate tahmini)
+            double dur = keyframe_index_duration_sec(&st->index);
+            if (dur > 0.0) {
+                AVStream* s = st->fmt->streams[seek_stream_index(st)];
+                st->fmt->duration = (int64_t)(dur * AV_TIME_BASE);
+                s->duration = st->index.info.end_pts - st->index.info.start_pts;
+            }
+            return true;
+        }
+        std::printf("index: sidecar doesn't match the file, reprobing\n");
+        keyframe_index_unload(&st->index);
+        if (st->fmt) avformat_close_input(&st->fmt);
+    }
+    return open_input(st, filename, false);
+}
+
+// İndeksteki keyframe'e seek: zaman damgası süreksiz olabilen formatlarda
+// (MPEG-TS) offset'e, diğerlerinde (mp4, mkv) keyframe'in kendi zaman damgasına.
+// ffplay kuralı: mkv'de pkt->pos cluster içini gösterir, byte seek bir sonraki
+// cluster'a kayar. Başarısızsa <0.
+static int seek_indexed(DemuxerState* st, int idx, int64_t ts) {
+    KeyframeIndexEntry e;
+    if (!keyframe_index_lookup(&st->index, ts, &e)) return -1;
+    const int fmt_flags = st->fmt->iformat->flags;
+    const bool by_bytes = (fmt_flags & AVFMT_TS_DISCONT) && !(fmt_flags & AVFMT_NO_BYTE_SEEK) &&
+                          std::strcmp(st->fmt->iformat->name, "ogg") != 0;
+    if (e.pos >= 0 && by_bytes)
+        return av_seek_frame(st->fmt, idx, e.pos, AVSEEK_FLAG_BYTE);
+    int64_t kts = (fmt_flags & AVFMT_SEEK_TO_PTS) || e.dts == AV_NOPTS_VALUE ? e.pts : e.dts;
+    return av_seek_frame(st->fmt, idx, kts, AVSEEK_FLAG_BACKWARD);
+}
+
+static void demux_loop(DemuxerState* st) {
+    stage_trace_thread_name("demux");
+    AVPacket* pkt = av_packet_alloc();
+    if (!pkt) { std::printf("demux: packet alloc failed\n"); return; }
+
+    std::unique_lock<std::mutex> lock(st->mtx);
+    while (!st->quit) {
+        if (st->seek_req) {
+            // Video varsa onun üzerinden (keyframe'e geri), yoksa ses stream'i
+            int idx = seek_stream_index(st);
+            AVRational tb = st->fmt->streams[idx]->time_base;
+            int64_t ts = (int64_t)llround(st->seek_target * tb.den / (double)tb.num);
+            int ret = seek_indexed(st, idx, ts);
+            if (ret < 0) ret = av_seek_frame(st->fmt, idx, ts, AVSEEK_FLAG_BACKWARD);
+            if (ret < 0) std::printf("demux: seek failed: %s\n", err2str(ret));
+            packet_queue_flush(&st->video_q, st->seek_target);
+            packet_queue_flush(&st->audio_q, st->seek_target);
+            st->eof = false;
+            st->seek_req = false;
+            st->cv.notify_all();
+            continue;
+        }
+        if (st->video_suspend_req != st->video_suspended) {
+            // Askıya alma: video paketleri demuxer'da atılır, kuyruk boşaltılır.
+            // Devam: kuyruk yeni serial'la açılır (decoder flush eder) ve ilk
+            // keyframe'e kadar gelen paketler atılır.
+            const bool suspend = st->video_suspend_req;
+            st->fmt->streams[st->video_stream_index]->discard = suspend ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+            packet_queue_flush(&st->video_q, 0.0, false);
+            {
+                std::lock_guard<std::mutex> qlock(st->video_q.mtx);
+                st->video_q.enabled = !suspend; // queues_full sadece sesi beklesin
+            }
+            if (st->eof) packet_queue_set_eof(&st->video_q);
+            st->video_suspended = suspend;
+            st->video_wait_key = !suspend;
+            st->cv.notify_all();
+            continue;
+        }
+        if (st->eof || queues_full(st)) {
+            st->cv.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        lock.unlock();
+        double t0 = stage_clock_now();
+        int ret = av_read_frame(st->fmt, pkt);
+        stage_trace_add(&st->stat_read_sec, "demux", t0);
+        lock.lock();
+
+        if (ret < 0) {
+            if (ret != AVERROR_EOF) std::printf("demux: read_frame: %s\n", err2str(ret));
+            st->eof = true;
+            packet_queue_set_eof(&st->video_q);
+            packet_queue_set_eof(&st->audio_q);
+            continue;
+        }
+        if (st->seek_req) { av_packet_unref(pkt); continue; } // seek öncesi paket
+
+        PacketQueue* q = nullptr;
+        if (pkt->stream_index == st->video_stream_index)      q = &st->video_q;
+        else if (pkt->stream_index == st->audio_stream_index) q = &st->audio_q;
+        if (q == &st->video_q && st->video_wait_key) {
+            if (!(pkt->flags & AV_PKT_FLAG_KEY)) { av_packet_unref(pkt); continue; }
+            st->video_wait_key = false;
+        }
+        if (q && q->enabled) packet_queue_put(q, pkt);
+        else                 av_packet_unref(pkt);
+    }
+    lock.unlock();
+    av_packet_free(&pkt);
+}
+
+void demuxer_start(DemuxerState* st) {
+    st->quit = false; st->eof = false; st->seek_req = false;
+    // Okuyucusu olmayan stream'ler (ses açılmadıysa ses, altyazı, ek parçalar)
+    // demuxer'da atılır: paketleri okunmaz/kopyalanmaz
+    for (unsigned i = 0; i < st->fmt->nb_streams; ++i) {
+        const bool used = ((int)i == st->video_stream_index && st->video_q.enabled) ||
+                          ((int)i == st->audio_stream_index && st->audio_q.enabled);
+        st->fmt->streams[i]->discard = used ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+    st->thread = std::thread(demux_loop, st);
+    if (st->build_index) keyframe_index_start(&st->index, st->path.c_str(), seek_stream_index(st));
+}
+
+bool demuxer_seek(DemuxerState* st, double seconds) {
+    if (!st || !st->fmt || !st->thread.joinable()) return false;
+    std::unique_lock<std::mutex> lock(st->mtx);
+    st->seek_target = seconds;
+    st->seek_req = true;
+    st->cv.notify_all();
+    st->cv.wait(lock, [st] { return !st->seek_req || st->quit; });
+    return !st->seek_req;
+}
+
+bool demuxer_set_video_suspended(DemuxerState* st, bool suspended) {
+    if (!st || !st->fmt || !st->thread.joinable() || st->video_stream_index < 0) return false;
+    std::unique_lock<std::mutex> lock(st->mtx);
+    st->video_suspend_req = suspended;
+    st->cv.notify_all();
+    st->cv.wait(lock, [st] { return st->video_suspended == st->video_suspend_req || st->quit; });
+    return st->video_suspended == suspended;
+}
+
+void demuxer_stop(DemuxerState* st) {
+    {
+        std::lock_guard<std::mutex> lock(st->mtx);
+        st->quit = true;
+    }
+    st->cv.notify_all();
+    packet_queue_abort(&st->video_q);
+    packet_queue_abort(&st->audio_q);
+    if (st->thread.joinable()) st->thread.join();
+    keyframe_index_stop(&st->index);
+}
+
+void demuxer_close(DemuxerState* st) {
+    demuxer_stop(st);
+    keyframe_index_unload(&st->index); // thread durdu: sidecar map'i bırakılır
+    for (PacketQueue* q : { &st->video_q, &st->audio_q }) {
+        for (auto& e : q->q) av_packet_free(&e.pkt);
+        q->q.clear();
+        q->bytes = 0;
+    }
+    if (st->fmt) { avformat_close_input(&st->fmt); avformat_free_context(st->fmt); }
+}
+
+double demuxer_get_duration_sec(const DemuxerState* st) {
+    if (!st || !st->fmt) return 0.0;
+    if (st->fmt->duration > 0) return (double)st->fmt->duration / (double)AV_TIME_BASE;
+    return 0.0; // bilinmiyor (ör. canlı yayın)
+}
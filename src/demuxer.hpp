@@ -0,0 +1,85 @@
+#ifndef demuxer_hpp
+#define demuxer_hpp
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+#include "keyframe_index.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Tek stream için paket kuyruğu (demux thread -> decoder).
+// `serial` her flush'ta (seek) artar; decoder'lar farkı görünce kendini flush eder.
+struct PacketQueue {
+    struct Entry { AVPacket* pkt; int serial; };
+
+    bool                    enabled = false; // false ise demuxer bu stream'in paketlerini atar
+    std::deque<Entry>       q;
+    size_t                  bytes  = 0;
+    int                     serial = 0;
+    double                  start_sec = 0.0;  // bu serial'ın seek hedefi (saniye)
+    bool                    has_start = false;
+    bool                    eof = false, abort = false;
+    std::mutex              mtx;
+    std::condition_variable cv;
+};
+
+// 1: paket alındı, 0: paket yok (block=false), -1: EOF (kuyruk boş) veya abort.
+// `serial` her durumda kuyruğun o anki serial'ı ile doldurulur.
+int  packet_queue_get(PacketQueue* q, AVPacket* pkt, int* serial, bool block);
+int  packet_queue_serial(PacketQueue* q);
+// `serial` hâlâ güncelse ve bir seek ile başladıysa hedefini döner
+bool packet_queue_serial_start(PacketQueue* q, int serial, double* start_sec);
+int  packet_queue_size(PacketQueue* q);
+
+struct DemuxerState {
+    // Public
+    int video_stream_index = -1;
+    int audio_stream_index = -1;
+    PacketQueue video_q, audio_q;
+    double      stat_read_sec = 0.0; // av_read_frame toplam süresi (demux thread)
+    bool        build_index = true;  // demuxer_start arka planda keyframe indeksi kurar
+
+    // Private
+    AVFormatContext*        fmt = nullptr;
+    std::string             path;
+    KeyframeIndex           index; // seek stream'i (video, yoksa ses)
+    std::thread             thread;
+    std::mutex              mtx;
+    std::condition_variable cv;
+    bool                    quit = false, eof = false;
+    bool                    seek_req = false;
+    double                  seek_target = 0.0;
+    bool                    video_suspend_req = false, video_suspended = false;
+    bool                    video_wait_key = false; // devamda ilk keyframe'e kadar video paketleri atılır
+};
+
+// Dosyayı bir kez açar/probe eder ve en iyi video/ses stream'lerini seçer.
+bool demuxer_open(DemuxerState* st, const char* filename);
+
+// Okuma thread'ini (ve build_index ise indeks thread'ini) başlatır; önce
+// reader'lar açılmalı (kuyrukları enable eder).
+void demuxer_start(DemuxerState* st);
+
+// Senkron seek (seconds): dönünce kuyruklar flush edilmiş ve serial artmış olur.
+// İndeks hedefi kapsıyorsa doğrudan keyframe'in byte offset'ine atlar.
+bool demuxer_seek(DemuxerState* st, double seconds);
+
+// Senkron: askıdayken video stream'i demuxer'da atılır (AVDISCARD_ALL), paket
+// kuyruğu boşalır ve decoder bekler. Devamda kuyruk serial'ı artar (decoder
+// flush eder), video sonraki keyframe'den başlar. Dönünce video_decoder_flush.
+bool demuxer_set_video_suspended(DemuxerState* st, bool suspended);
+
+// Kuyrukları abort eder (bekleyen decoder'lar uyanır) ve thread'i durdurur.
+void demuxer_stop(DemuxerState* st);
+void demuxer_close(DemuxerState* st);
+
+// süre (saniye). Bilinmiyorsa <=0 dönebilir.
+double demuxer_get_duration_sec(const DemuxerState* st);
+
+#endif
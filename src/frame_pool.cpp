@@ -0,0 +1,163 @@
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+#include "frame_pool.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+// Hizalı ayırma: asıl pointer hizalı bloğun hemen önünde saklanır
+static uint8_t* aligned_alloc_buffer(size_t size) {
+    uint8_t* raw = (uint8_t*)std::malloc(size + FRAME_POOL_ALIGN + sizeof(void*));
+    if (!raw) return nullptr;
+    uintptr_t p = ((uintptr_t)(raw + sizeof(void*)) + FRAME_POOL_ALIGN - 1) & ~(uintptr_t)(FRAME_POOL_ALIGN - 1);
+    ((void**)p)[-1] = raw;
+    return (uint8_t*)p;
+}
+
+static void aligned_free_buffer(uint8_t* p) {
+    if (p) std::free(((void**)p)[-1]);
+}
+
+FramePool* frame_pool_create(size_t buffer_size, int capacity) {
+    FramePool* pool = new FramePool();
+    pool->stats.buffer_size = buffer_size;
+    pool->stats.capacity = capacity;
+    pool->free_list.reserve(capacity > 0 ? capacity : 0);
+    return pool;
+}
+
+// AVBuffer'ın son referansı bırakılınca (herhangi bir thread'den)
+static void pool_return(void* opaque, uint8_t* data) {
+    FramePool* pool = (FramePool*)opaque;
+    bool destroy = false;
+    {
+        std::lock_guard<std::mutex> lock(pool->mtx);
+        pool->stats.in_use--;
+        if (pool->released) {
+            aligned_free_buffer(data);
+            destroy = --pool->stats.allocated == 0;
+        } else {
+            pool->free_list.push_back(data);
+        }
+    }
+    if (destroy) delete pool;
+}
+
+AVBufferRef* frame_pool_get(FramePool* pool) {
+    uint8_t* data = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pool->mtx);
+        FramePoolStats& s = pool->stats;
+        if (!pool->free_list.empty()) {
+            data = pool->free_list.back();
+            pool->free_list.pop_back();
+            s.reuses++;
+        } else if (s.allocated < s.capacity && (data = aligned_alloc_buffer(s.buffer_size))) {
+            s.allocated++;
+            s.allocations++;
+        } else {
+            s.exhausted++;
+            return nullptr;
+        }
+        s.in_use++;
+        s.peak_in_use = std::max(s.peak_in_use, s.in_use);
+    }
+    AVBufferRef* ref = av_buffer_create(data, pool->stats.buffer_size, pool_return, pool, 0);
+    if (!ref) pool_return(pool, data);
+    return ref;
+}
+
+FramePoolStats frame_pool_stats(FramePool* pool) {
+    if (!pool) return FramePoolStats();
+    std::lock_guard<std::mutex> lock(pool->mtx);
+    return pool->stats;
+}
+
+void frame_pool_release(FramePool** pp) {
+    FramePool* pool = *pp;
+    if (!pool) return;
+    *pp = nullptr;
+    bool destroy = false;
+    {
+        std::lock_guard<std::mutex> lock(pool->mtx);
+        pool->released = true;
+        for (uint8_t* p : pool->free_list) aligned_free_buffer(p);
+        pool->stats.allocated -= (int)pool->free_list.size();
+        pool->free_list.clear();
+        destroy = pool->stats.allocated == 0;
+    }
+    if (destroy) delete pool;
+}
+
+// --- Decoder kareleri ---
+
+int decoder_frame_pool_get_buffer(AVCodecContext* ctx, AVFrame* frame, int flags) {
+    DecoderFramePool* dp = (DecoderFramePool*)ctx->opaque;
+    const AVPixelFormat fmt = (AVPixelFormat)frame->format;
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(fmt);
+    if (!dp || dp->capacity <= 0 || !(ctx->codec->capabilities & AV_CODEC_CAP_DR1) || !desc ||
+        (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_BITSTREAM)))
+        return avcodec_default_get_buffer2(ctx, frame, flags);
+
+    // Codec'in kenar payı ve satır hizalaması (ör. h264 16'lık makroblok + kenar)
+    int w = frame->width, h = frame->height;
+    int align[AV_NUM_DATA_POINTERS];
+    avcodec_align_dimensions2(ctx, &w, &h, align);
+    // Satırlar düzlem düzlem yuvarlanmaz: Y/UV oranı (ör. yuv420p'de
+    // linesize[0] == 2*linesize[1]) bazı decoder'ların varsayımı. FFmpeg'in
+    // varsayılan allocator'ı gibi genişlik, tüm düzlemler hizalanana kadar artırılır.
+    const int planes = av_pix_fmt_count_planes(fmt);
+    int linesize[4];
+    for (int lw = w;; lw += lw & -lw) { // en düşük bit kadar: sonunda yeterince büyük 2'nin katı
+        if (av_image_fill_linesizes(linesize, fmt, lw) < 0)
+            return avcodec_default_get_buffer2(ctx, frame, flags);
+        bool unaligned = false;
+        for (int p = 0; p < planes; ++p)
+            unaligned |= linesize[p] % std::max(FRAME_POOL_ALIGN, align[p]) != 0;
+        if (!unaligned) break;
+    }
+
+    size_t offset[4] = { 0, 0, 0, 0 }, total = 0;
+    for (int p = 0; p < planes; ++p) {
+        const int ph = (p == 1 || p == 2) ? -((-h) >> desc->log2_chroma_h) : h;
+        offset[p] = total;
+        total += (size_t)linesize[p] * ph;
+        total = (total + FRAME_POOL_ALIGN - 1) & ~(size_t)(FRAME_POOL_ALIGN - 1);
+    }
+    total += AV_INPUT_BUFFER_PADDING_SIZE; // SIMD okumaları son satırı aşabilir
+
+    AVBufferRef* buf = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(dp->mtx);
+        // Çözünürlük/format değişti: eski havuz dışarıdaki kareler dönünce silinir
+        if (!dp->pool || dp->format != (int)fmt || dp->width != w || dp->height != h) {
+            frame_pool_release(&dp->pool);
+            dp->pool = frame_pool_create(total, dp->capacity);
+            dp->format = (int)fmt; dp->width = w; dp->height = h;
+        }
+        buf = frame_pool_get(dp->pool);
+        if (!buf) dp->fallbacks++;
+    }
+    if (!buf) return avcodec_default_get_buffer2(ctx, frame, flags);
+
+    frame->buf[0] = buf;
+    for (int p = 0; p < planes; ++p) {
+        frame->data[p] = buf->data + offset[p];
+        frame->linesize[p] = linesize[p];
+    }
+    frame->extended_data = frame->data;
+    return 0;
+}
+
+FramePoolStats decoder_frame_pool_stats(DecoderFramePool* dp) {
+    std::lock_guard<std::mutex> lock(dp->mtx);
+    FramePoolStats s = frame_pool_stats(dp->pool);
+    s.fallbacks = dp->fallbacks;
+    return s;
+}
+
+void decoder_frame_pool_close(DecoderFramePool* dp) {
+    std::lock_guard<std::mutex> lock(dp->mtx);
+    frame_pool_release(&dp->pool);
+}
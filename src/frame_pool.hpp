@@ -0,0 +1,68 @@
+#ifndef frame_pool_hpp
+#define frame_pool_hpp
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+}
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Sabit boyutlu, 64-byte hizalı buffer havuzu. Buffer'lar AVBufferRef olarak
+// verilir (FFmpeg'in referans sayacı): son referans bırakılınca buffer
+// allocator'a değil havuza döner. Hem decoder karelerini (get_buffer2) hem
+// dönüştürülmüş RGBA karelerini taşır.
+static const int FRAME_POOL_ALIGN = 64;
+
+struct FramePoolStats {
+    size_t  buffer_size = 0;
+    int     capacity = 0;
+    int     allocated = 0;   // havuzun sahip olduğu buffer'lar (<= capacity)
+    int     in_use = 0, peak_in_use = 0;
+    int64_t allocations = 0; // allocator'a gidilen (ısındıktan sonra artmamalı)
+    int64_t reuses = 0;      // havuzdan geri dönüştürülen
+    int64_t exhausted = 0;   // capacity doluyken gelen istekler (nullptr döndü)
+    int64_t fallbacks = 0;   // (decoder) havuz dışı, varsayılan allocator'la ayrılan kareler
+};
+
+struct FramePool {
+    // Private: buffer'lar havuzdan uzun yaşayabilir (ör. decoder'ın tuttuğu
+    // referans kareler); son buffer dönene kadar silinmez.
+    std::mutex            mtx;
+    std::vector<uint8_t*> free_list; // hizalı pointer'lar
+    FramePoolStats        stats;
+    bool                  released = false;
+};
+
+// `capacity` aynı anda en fazla kaç buffer olabileceği.
+FramePool*   frame_pool_create(size_t buffer_size, int capacity);
+// Boşta buffer yoksa ve capacity dolmadıysa yeni ayırır; doluysa nullptr.
+AVBufferRef* frame_pool_get(FramePool* pool);
+FramePoolStats frame_pool_stats(FramePool* pool);
+// Sahipliği bırakır; dışarıda kalan buffer'lar dönünce havuz silinir.
+void         frame_pool_release(FramePool** pool);
+
+// Satır uzunluğu (byte) FRAME_POOL_ALIGN katına yuvarlanmış
+inline int frame_pool_stride(int row_bytes) {
+    return (row_bytes + FRAME_POOL_ALIGN - 1) & ~(FRAME_POOL_ALIGN - 1);
+}
+
+// AVCodecContext::get_buffer2 için: düzlemler havuzdan tek buffer'da, her satır
+// 64-byte hizalı ve codec'in istediği kenar payıyla. ctx->opaque bir
+// DecoderFramePool* olmalı. Havuz kullanılamıyorsa (DR1 yok, paletli/hwaccel
+// format, capacity dolu) avcodec_default_get_buffer2'ye düşer.
+struct DecoderFramePool {
+    std::mutex mtx;       // get_buffer2 frame thread'lerinden sırayla çağrılır
+    FramePool* pool = nullptr;
+    int        format = -1, width = 0, height = 0;
+    int        capacity = 0;
+    int64_t    fallbacks = 0; // varsayılan allocator'a düşülen kareler
+};
+
+int            decoder_frame_pool_get_buffer(AVCodecContext* ctx, AVFrame* frame, int flags);
+FramePoolStats decoder_frame_pool_stats(DecoderFramePool* dp);
+void           decoder_frame_pool_close(DecoderFramePool* dp);
+
+#endif
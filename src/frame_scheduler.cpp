@@ -0,0 +1,44 @@
+#include "frame_scheduler.hpp"
+#include <cmath>
+
+static const double DRIFT_EMA = 0.05;
+
+void frame_scheduler_init(FrameScheduler* s, double frame_duration) {
+    *s = FrameScheduler();
+    if (frame_duration > 0.0) s->frame_duration = frame_duration;
+}
+
+void frame_scheduler_reset(FrameScheduler* s) {
+    s->have_last = false;
+}
+
+FrameAction frame_scheduler_decide(double pts, const double* next_pts, double clock) {
+    if (pts > clock) return FRAME_WAIT;
+    // Bu karenin gösterim aralığı geçmiş ve yerine geçecek kare hazır
+    if (next_pts && *next_pts <= clock) return FRAME_DROP;
+    return FRAME_PRESENT;
+}
+
+void frame_scheduler_dropped(FrameScheduler* s) {
+    s->stats.dropped++;
+}
+
+void frame_scheduler_presented(FrameScheduler* s, double pts, double clock) {
+    const double drift = clock - pts;
+    FrameSchedulerStats& st = s->stats;
+    st.presented++;
+    if (drift > s->frame_duration) st.late++;
+    st.drift = (st.presented == 1) ? drift : st.drift + (drift - st.drift) * DRIFT_EMA;
+    if (std::fabs(drift) > std::fabs(st.max_drift)) st.max_drift = drift;
+    s->have_last = true;
+    s->next_due = pts + s->frame_duration;
+}
+
+void frame_scheduler_idle(FrameScheduler* s, double clock) {
+    if (!s->have_last) return;
+    // son karenin süresi doldu ama decoder yetişemedi: her kaçan periyot bir tekrar
+    while (clock > s->next_due) {
+        s->stats.duplicated++;
+        s->next_due += s->frame_duration;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef frame_scheduler_hpp
+#define frame_scheduler_hpp
+
+#include <cstdint>
+
+// Video kare zamanlaması (master clock'a göre). Tüm zamanlar saniye.
+struct FrameSchedulerStats {
+    int64_t presented  = 0;
+    int64_t dropped    = 0; // dönüştürülmeden atılan geç kareler
+    int64_t late       = 0; // bir kare süresinden fazla gecikmeyle gösterilenler
+    int64_t duplicated = 0; // sıradaki kare zamanında hazır değildi, eskisi tekrarlandı
+    double  drift      = 0.0; // clock - pts, sunumda (EMA; +: video geride)
+    double  max_drift  = 0.0;
+};
+
+struct FrameScheduler {
+    // Public
+    double              frame_duration = 1.0 / 30.0;
+    FrameSchedulerStats stats;
+
+    // Private
+    bool   have_last = false;
+    double next_due = 0.0; // son gösterilen karenin yerine yenisinin gelmesi gereken an
+};
+
+enum FrameAction {
+    FRAME_WAIT,    // henüz zamanı gelmedi
+    FRAME_PRESENT, // şimdi göster
+    FRAME_DROP,    // geç ve sıradaki kare de zamanı gelmiş: dönüştürmeden at
+};
+
+void frame_scheduler_init(FrameScheduler* s, double frame_duration);
+// seek sonrası: son kare bilgisini unut (istatistikler korunur)
+void frame_scheduler_reset(FrameScheduler* s);
+
+// Durumsuz karar; `next_pts` nullptr ise kuyrukta sıradaki kare yok (son kare asla atılmaz).
+FrameAction frame_scheduler_decide(double pts, const double* next_pts, double clock);
+void frame_scheduler_dropped(FrameScheduler* s);
+void frame_scheduler_presented(FrameScheduler* s, double pts, double clock);
+// oynatılırken gösterilecek kare yoksa çağrılır
+void frame_scheduler_idle(FrameScheduler* s, double clock);
+
+#endif
@@ -0,0 +1,55 @@
+#include "gl_ext.hpp"
+#include <cstdio>
+
+GlExt gl_ext;
+
+// Hepsi bulunursa true; eksik varsa gruptaki hiçbir fonksiyon kullanılmaz
+template <size_t N>
+static bool load_group(const char* const (&names)[N], void* const (&ptrs)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+        GLFWglproc p = glfwGetProcAddress(names[i]);
+        if (!p) return false;
+        *(GLFWglproc*)ptrs[i] = p;
+    }
+    return true;
+}
+
+void gl_ext_load() {
+    if (gl_ext.loaded) return;
+    gl_ext.loaded = true;
+
+    const char* ver = (const char*)glGetString(GL_VERSION);
+    int major = 0, minor = 0;
+    if (!ver || std::sscanf(ver, "%d.%d", &major, &minor) < 1) return;
+    const int version = major * 10 + minor;
+
+    static const char* const shader_names[] = {
+        "glCreateShader", "glShaderSource", "glCompileShader", "glGetShaderiv",
+        "glGetShaderInfoLog", "glDeleteShader", "glCreateProgram", "glAttachShader",
+        "glLinkProgram", "glGetProgramiv", "glGetProgramInfoLog", "glDeleteProgram",
+        "glUseProgram", "glGetUniformLocation", "glUniform1i", "glUniform1f",
+        "glUniform4f", "glActiveTexture",
+    };
+    void* const shader_ptrs[] = {
+        &gl_ext.CreateShader, &gl_ext.ShaderSource, &gl_ext.CompileShader, &gl_ext.GetShaderiv,
+        &gl_ext.GetShaderInfoLog, &gl_ext.DeleteShader, &gl_ext.CreateProgram, &gl_ext.AttachShader,
+        &gl_ext.LinkProgram, &gl_ext.GetProgramiv, &gl_ext.GetProgramInfoLog, &gl_ext.DeleteProgram,
+        &gl_ext.UseProgram, &gl_ext.GetUniformLocation, &gl_ext.Uniform1i, &gl_ext.Uniform1f,
+        &gl_ext.Uniform4f, &gl_ext.ActiveTexture,
+    };
+    gl_ext.shaders = version >= 20 && load_group(shader_names, shader_ptrs);
+
+    static const char* const buffer_names[] = {
+        "glGenBuffers", "glDeleteBuffers", "glBindBuffer", "glBufferData", "glMapBuffer", "glUnmapBuffer",
+    };
+    void* const buffer_ptrs[] = {
+        &gl_ext.GenBuffers, &gl_ext.DeleteBuffers, &gl_ext.BindBuffer, &gl_ext.BufferData,
+        &gl_ext.MapBuffer, &gl_ext.UnmapBuffer,
+    };
+    const bool has_pbo = version >= 21 ||
+                         (version >= 15 && glfwExtensionSupported("GL_ARB_pixel_buffer_object"));
+    gl_ext.pbo = has_pbo && load_group(buffer_names, buffer_ptrs);
+
+    std::printf("gl: %s (shaders: %s, pbo: %s)\n", ver,
+                gl_ext.shaders ? "yes" : "no", gl_ext.pbo ? "yes" : "no");
+}
@@ -0,0 +1,84 @@
+#ifndef gl_ext_hpp
+#define gl_ext_hpp
+
+#include <GLFW/glfw3.h>
+#include <cstddef>
+
+// OpenGL 1.1 üstü (Windows'un gl.h'ı 1.1'de kalır) sabitler ve fonksiyonlar.
+// Fonksiyonlar glfwGetProcAddress ile yüklenir; mevcut bir GL context'i gerekir.
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER  0x8B30
+#define GL_VERTEX_SHADER    0x8B31
+#define GL_COMPILE_STATUS   0x8B81
+#define GL_LINK_STATUS      0x8B82
+#define GL_INFO_LOG_LENGTH  0x8B84
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_LUMINANCE_ALPHA
+#define GL_LUMINANCE_ALPHA 0x190A
+#endif
+#ifndef GL_LUMINANCE16
+#define GL_LUMINANCE16 0x8042
+#endif
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#define GL_WRITE_ONLY  0x88B9
+#endif
+
+#if defined(_WIN32) && !defined(_WIN64)
+#define GL_EXT_APIENTRY __stdcall
+#else
+#define GL_EXT_APIENTRY
+#endif
+
+struct GlExt {
+    bool loaded = false;
+    bool shaders = false; // GL 2.0: GLSL program'ları
+    bool pbo = false;     // GL 2.1 / ARB_pixel_buffer_object
+
+    // GL 2.0
+    GLuint (GL_EXT_APIENTRY *CreateShader)(GLenum);
+    void   (GL_EXT_APIENTRY *ShaderSource)(GLuint, GLsizei, const char* const*, const GLint*);
+    void   (GL_EXT_APIENTRY *CompileShader)(GLuint);
+    void   (GL_EXT_APIENTRY *GetShaderiv)(GLuint, GLenum, GLint*);
+    void   (GL_EXT_APIENTRY *GetShaderInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    void   (GL_EXT_APIENTRY *DeleteShader)(GLuint);
+    GLuint (GL_EXT_APIENTRY *CreateProgram)(void);
+    void   (GL_EXT_APIENTRY *AttachShader)(GLuint, GLuint);
+    void   (GL_EXT_APIENTRY *LinkProgram)(GLuint);
+    void   (GL_EXT_APIENTRY *GetProgramiv)(GLuint, GLenum, GLint*);
+    void   (GL_EXT_APIENTRY *GetProgramInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    void   (GL_EXT_APIENTRY *DeleteProgram)(GLuint);
+    void   (GL_EXT_APIENTRY *UseProgram)(GLuint);
+    GLint  (GL_EXT_APIENTRY *GetUniformLocation)(GLuint, const char*);
+    void   (GL_EXT_APIENTRY *Uniform1i)(GLint, GLint);
+    void   (GL_EXT_APIENTRY *Uniform1f)(GLint, GLfloat);
+    void   (GL_EXT_APIENTRY *Uniform4f)(GLint, GLfloat, GLfloat, GLfloat, GLfloat);
+    void   (GL_EXT_APIENTRY *ActiveTexture)(GLenum);
+
+    // GL 1.5 buffer object'leri (PBO için)
+    void   (GL_EXT_APIENTRY *GenBuffers)(GLsizei, GLuint*);
+    void   (GL_EXT_APIENTRY *DeleteBuffers)(GLsizei, const GLuint*);
+    void   (GL_EXT_APIENTRY *BindBuffer)(GLenum, GLuint);
+    void   (GL_EXT_APIENTRY *BufferData)(GLenum, ptrdiff_t, const void*, GLenum);
+    void*  (GL_EXT_APIENTRY *MapBuffer)(GLenum, GLenum);
+    GLboolean (GL_EXT_APIENTRY *UnmapBuffer)(GLenum);
+};
+
+extern GlExt gl_ext;
+
+// Context başına bir kez; sonraki çağrılar hiçbir şey yapmaz.
+void gl_ext_load();
+
+#endif
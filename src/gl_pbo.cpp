@@ -0,0 +1,45 @@
+#include "gl_pbo.hpp"
+
+bool gl_pbo_init(GlPboRing* r, int count) {
+    gl_ext_load();
+    if (!gl_ext.pbo) return false;
+    r->count = count < 1 ? 1 : count > GlPboRing::MAX ? GlPboRing::MAX : count;
+    gl_ext.GenBuffers(r->count, r->buf);
+    return true;
+}
+
+uint8_t* gl_pbo_map(GlPboRing* r, size_t bytes) {
+    if (r->count == 0 || bytes == 0) return nullptr;
+    const int i = r->next;
+    r->next = (r->next + 1) % r->count;
+    gl_ext.BindBuffer(GL_PIXEL_UNPACK_BUFFER, r->buf[i]);
+    // Sadece büyürken yeniden ayır; aynı boyutta halka senkronu önler
+    if (bytes > r->cap[i]) {
+        gl_ext.BufferData(GL_PIXEL_UNPACK_BUFFER, (ptrdiff_t)bytes, nullptr, GL_STREAM_DRAW);
+        r->cap[i] = bytes;
+    }
+    void* p = gl_ext.MapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (!p) {
+        gl_ext.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return nullptr;
+    }
+    r->bound = i;
+    return (uint8_t*)p;
+}
+
+bool gl_pbo_unmap(GlPboRing* r) {
+    if (r->bound < 0) return false;
+    return gl_ext.UnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+}
+
+void gl_pbo_unbind(GlPboRing* r) {
+    if (r->bound < 0) return;
+    gl_ext.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    r->bound = -1;
+}
+
+void gl_pbo_destroy(GlPboRing* r) {
+    gl_pbo_unbind(r);
+    if (r->count > 0) gl_ext.DeleteBuffers(r->count, r->buf);
+    *r = GlPboRing();
+}
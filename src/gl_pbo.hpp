@@ -0,0 +1,37 @@
+#ifndef gl_pbo_hpp
+#define gl_pbo_hpp
+
+#include "gl_ext.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Texture yüklemesi için pixel buffer object halkası. Kare doğrudan map edilmiş
+// PBO belleğine yazılır (ara heap buffer yok), glTexSubImage2D PBO'dan okur ve
+// hemen döner: kopyayı driver arka planda yapar, render ile örtüşür. Her kare
+// sıradaki PBO'yu kullanır; bir önceki karenin transferi sürerken map beklemez.
+struct GlPboRing {
+    static const int MAX = 4;
+    GLuint buf[MAX] = { 0, 0, 0, 0 };
+    size_t cap[MAX] = { 0, 0, 0, 0 };
+    int    count = 0, next = 0;
+    int    bound = -1; // map/unmap arasında ve yükleme bitene kadar bağlı PBO
+};
+
+// GL 2.1 (ya da ARB_pixel_buffer_object) yoksa false: çağıran doğrudan yükler.
+bool gl_pbo_init(GlPboRing* r, int count = 2);
+
+// Sıradaki PBO'yu GL_PIXEL_UNPACK_BUFFER'a bağlar ve `bytes` için yazmaya açar.
+// Başarısızsa nullptr döner ve hiçbir PBO bağlı kalmaz.
+uint8_t* gl_pbo_map(GlPboRing* r, size_t bytes);
+
+// Yazma bitti. PBO bağlı kalır: bu noktadan sonra glTexSubImage2D'nin data
+// argümanı PBO içindeki byte offset'tir. false: içerik bozuldu (kareyi atla).
+bool gl_pbo_unmap(GlPboRing* r);
+
+// Yüklemeler bitti; GL_PIXEL_UNPACK_BUFFER'ı çözer (sonraki glTexSubImage2D
+// çağrıları yine istemci belleğinden okur).
+void gl_pbo_unbind(GlPboRing* r);
+
+void gl_pbo_destroy(GlPboRing* r);
+
+#endif
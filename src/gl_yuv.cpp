@@ -0,0 +1,214 @@
+#include "gl_yuv.hpp"
+#include "gl_ext.hpp"
+#include "gl_pbo.hpp"
+#include "yuv_convert.hpp"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const char* VERTEX_SRC =
+    "#version 120\n"
+    "void main() {\n"
+    "    gl_Position = ftransform();\n"
+    "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "}\n";
+
+// range: (örnek -> kod değeri ölçeği, yoff, coff, ycoef), coef: (rv, gu, gv, bu).
+// Katsayılar yuv_convert'in Q14 değerlerinden; kod değerini 0..1 RGB'ye çevirir.
+static const char* FRAGMENT_SRC =
+    "#version 120\n"
+    "uniform sampler2D tex_y, tex_u, tex_v;\n"
+    "uniform vec4 range;\n"
+    "uniform vec4 coef;\n"
+    "uniform float nv12;\n"
+    "void main() {\n"
+    "    vec2 tc = gl_TexCoord[0].st;\n"
+    "    vec4 c = texture2D(tex_u, tc);\n"
+    "    float y = (texture2D(tex_y, tc).r * range.x - range.y) * range.w;\n"
+    "    float u = c.r * range.x - range.z;\n"
+    "    float v = mix(texture2D(tex_v, tc).r, c.a, nv12) * range.x - range.z;\n"
+    "    gl_FragColor = vec4(y + coef.x * v, y - coef.y * u - coef.z * v, y + coef.w * u, 1.0);\n"
+    "}\n";
+
+static GLuint compile(GLenum type, const char* src) {
+    GLuint sh = gl_ext.CreateShader(type);
+    gl_ext.ShaderSource(sh, 1, &src, nullptr);
+    gl_ext.CompileShader(sh);
+    GLint ok = 0, len = 0;
+    gl_ext.GetShaderiv(sh, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        gl_ext.GetShaderiv(sh, GL_INFO_LOG_LENGTH, &len);
+        std::vector<char> log(len > 1 ? len : 1, 0);
+        gl_ext.GetShaderInfoLog(sh, (GLsizei)log.size(), nullptr, log.data());
+        std::printf("gl_yuv: shader compile failed: %s\n", log.data());
+        gl_ext.DeleteShader(sh);
+        return 0;
+    }
+    return sh;
+}
+
+bool gl_yuv_init(GlYuvRenderer* r) {
+    gl_ext_load();
+    if (!gl_ext.shaders) return false;
+    GLuint vs = compile(GL_VERTEX_SHADER, VERTEX_SRC);
+    GLuint fs = vs ? compile(GL_FRAGMENT_SHADER, FRAGMENT_SRC) : 0;
+    if (!fs) { if (vs) gl_ext.DeleteShader(vs); return false; }
+
+    r->program = gl_ext.CreateProgram();
+    gl_ext.AttachShader(r->program, vs);
+    gl_ext.AttachShader(r->program, fs);
+    gl_ext.LinkProgram(r->program);
+    gl_ext.DeleteShader(vs); // program'a bağlı kaldıkça silinmez
+    gl_ext.DeleteShader(fs);
+    GLint ok = 0;
+    gl_ext.GetProgramiv(r->program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[512] = { 0 };
+        gl_ext.GetProgramInfoLog(r->program, sizeof(log), nullptr, log);
+        std::printf("gl_yuv: program link failed: %s\n", log);
+        gl_yuv_destroy(r);
+        return false;
+    }
+
+    const char* names[3] = { "tex_y", "tex_u", "tex_v" };
+    gl_ext.UseProgram(r->program);
+    for (int i = 0; i < 3; ++i) {
+        r->loc_tex[i] = gl_ext.GetUniformLocation(r->program, names[i]);
+        gl_ext.Uniform1i(r->loc_tex[i], i); // sampler i -> texture unit i
+    }
+    r->loc_range = gl_ext.GetUniformLocation(r->program, "range");
+    r->loc_coef  = gl_ext.GetUniformLocation(r->program, "coef");
+    r->loc_nv12  = gl_ext.GetUniformLocation(r->program, "nv12");
+    gl_ext.UseProgram(0);
+
+    glGenTextures(3, r->tex);
+    for (int i = 0; i < 3; ++i) {
+        glBindTexture(GL_TEXTURE_2D, r->tex[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    r->ok = true;
+    return true;
+}
+
+bool gl_yuv_supported(const AVFrame* frame) {
+    if (!yuv_convert_supported((AVPixelFormat)frame->format)) return false;
+    YuvMatrix matrix; bool full_range;
+    if (!yuv_frame_color(frame, &matrix, &full_range)) return false; // shader yalnız 601/709
+    for (int p = 0; p < 3; ++p)
+        if (frame->data[p] && frame->linesize[p] < 0) return false; // ters çevrilmiş düzlem
+    return true;
+}
+
+// Bir düzlemi texture'a yükler; boyut/format değiştiyse texture yeniden ayrılır.
+// PBO bağlıyken `data` PBO içindeki offset'tir.
+static void upload_plane(GlYuvRenderer* r, int i, const uint8_t* data, int linesize,
+                         int w, int h, GLint internal, GLenum format, GLenum type, int texel) {
+    glBindTexture(GL_TEXTURE_2D, r->tex[i]);
+    if (r->tex_w[i] != w || r->tex_h[i] != h || r->tex_fmt[i] != internal) {
+        glTexImage2D(GL_TEXTURE_2D, 0, internal, w, h, 0, format, type, nullptr);
+        r->tex_w[i] = w; r->tex_h[i] = h; r->tex_fmt[i] = internal;
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, linesize / texel);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, format, type, data);
+}
+
+static void set_color(GlYuvRenderer* r, const AVFrame* frame) {
+    YuvMatrix matrix; bool full_range;
+    yuv_frame_color(frame, &matrix, &full_range);
+    const int key = frame->format * 4 + (int)matrix * 2 + (full_range ? 1 : 0);
+    if (key == r->color_key) return;
+
+    YuvConverter cv;
+    yuv_converter_init(&cv, (AVPixelFormat)frame->format, matrix, full_range, YUV_KERNEL_SCALAR);
+    const YuvCoeffs& c = cv.coeffs;
+    const float q = 1.0f / (16384.0f * 255.0f); // Q14, 8-bit RGB -> 0..1
+    // Texture örneği 0..1: 8-bit'te kod/255, 10-bit (LUMINANCE16) kod/65535
+    const float code = frame->format == AV_PIX_FMT_YUV420P10LE ? 65535.0f : 255.0f;
+    gl_ext.UseProgram(r->program);
+    gl_ext.Uniform4f(r->loc_range, code, (float)c.yoff, (float)c.coff, c.ycoef * q);
+    gl_ext.Uniform4f(r->loc_coef, c.rv * q, c.gu * q, c.gv * q, c.bu * q);
+    gl_ext.Uniform1f(r->loc_nv12, frame->format == AV_PIX_FMT_NV12 ? 1.0f : 0.0f);
+    gl_ext.UseProgram(0);
+    r->color_key = key;
+}
+
+bool gl_yuv_upload(GlYuvRenderer* r, const AVFrame* frame, GlPboRing* pbo) {
+    if (!r->ok || !gl_yuv_supported(frame)) return false;
+    const int w = frame->width, h = frame->height;
+    const int cw = (w + 1) / 2, ch = (h + 1) / 2;
+    set_color(r, frame);
+
+    // Düzlemler: nv12 iki (Y, UV luminance-alpha), diğerleri üç; p10 16-bit texel
+    struct Plane { int w, h; GLint internal; GLenum format, type; int texel; };
+    Plane planes[3];
+    int n = 3;
+    if (frame->format == AV_PIX_FMT_NV12) {
+        planes[0] = { w, h, GL_LUMINANCE, GL_LUMINANCE, GL_UNSIGNED_BYTE, 1 };
+        planes[1] = { cw, ch, GL_LUMINANCE_ALPHA, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, 2 };
+        n = 2;
+    } else if (frame->format == AV_PIX_FMT_YUV420P10LE) {
+        for (int p = 0; p < 3; ++p)
+            planes[p] = { p ? cw : w, p ? ch : h, GL_LUMINANCE16, GL_LUMINANCE, GL_UNSIGNED_SHORT, 2 };
+    } else {
+        for (int p = 0; p < 3; ++p)
+            planes[p] = { p ? cw : w, p ? ch : h, GL_LUMINANCE, GL_LUMINANCE, GL_UNSIGNED_BYTE, 1 };
+    }
+
+    // PBO: düzlemler linesize korunarak art arda kopyalanır, yükleme offset'ten
+    const uint8_t* src[3] = { frame->data[0], frame->data[1], frame->data[2] };
+    size_t total = 0;
+    for (int p = 0; p < n; ++p) total += (size_t)frame->linesize[p] * planes[p].h;
+    uint8_t* mapped = pbo ? gl_pbo_map(pbo, total) : nullptr;
+    if (mapped) {
+        size_t off = 0;
+        for (int p = 0; p < n; ++p) {
+            const size_t bytes = (size_t)frame->linesize[p] * planes[p].h;
+            std::memcpy(mapped + off, frame->data[p], bytes);
+            src[p] = (const uint8_t*)(uintptr_t)off;
+            off += bytes;
+        }
+        if (!gl_pbo_unmap(pbo)) { gl_pbo_unbind(pbo); return false; }
+    }
+    for (int p = 0; p < n; ++p)
+        upload_plane(r, p, src[p], frame->linesize[p], planes[p].w, planes[p].h,
+                     planes[p].internal, planes[p].format, planes[p].type, planes[p].texel);
+    if (mapped) gl_pbo_unbind(pbo);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    r->fmt = (AVPixelFormat)frame->format;
+    r->width = w; r->height = h;
+    return true;
+}
+
+void gl_yuv_draw(GlYuvRenderer* r, int x0, int y0, int x1, int y1) {
+    if (!r->ok || r->fmt == AV_PIX_FMT_NONE) return;
+    // nv12'de V ayrı düzlem değil: unit 2'ye UV bağlanır, shader .a'yı kullanır
+    const GLuint v_tex = r->fmt == AV_PIX_FMT_NV12 ? r->tex[1] : r->tex[2];
+    const GLuint units[3] = { r->tex[0], r->tex[1], v_tex };
+    for (int i = 2; i >= 0; --i) {
+        gl_ext.ActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, units[i]);
+    }
+    gl_ext.UseProgram(r->program);
+    glBegin(GL_QUADS);
+        glTexCoord2d(0, 1); glVertex2i(x0, y0);
+        glTexCoord2d(1, 1); glVertex2i(x1, y0);
+        glTexCoord2d(1, 0); glVertex2i(x1, y1);
+        glTexCoord2d(0, 0); glVertex2i(x0, y1);
+    glEnd();
+    gl_ext.UseProgram(0);
+    for (int i = 2; i >= 0; --i) {
+        gl_ext.ActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void gl_yuv_destroy(GlYuvRenderer* r) {
+    if (r->tex[0]) glDeleteTextures(3, r->tex);
+    if (r->program) gl_ext.DeleteProgram(r->program);
+    *r = GlYuvRenderer();
+}
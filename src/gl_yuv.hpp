@@ -0,0 +1,48 @@
+#ifndef gl_yuv_hpp
+#define gl_yuv_hpp
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+#include "gl_pbo.hpp"
+
+// Decode edilmiş 4:2:0 kareyi düzlemleri ayrı texture olarak yükler (yuv420p:
+// 1.5 byte/piksel, RGBA'da 4) ve RGB'ye GLSL 1.20 fragment shader'da çevirir.
+// Desteklenen formatlar yuv_convert ile aynı (yuv420p, yuvj420p, nv12,
+// yuv420p10le); matris/aralık katsayıları da oradan gelir, böylece iki yol aynı
+// rengi verir. GL 2.0 fonksiyonları glfwGetProcAddress ile yüklenir; mevcut bir
+// GL context'i gerekir.
+struct GlYuvRenderer {
+    // Public
+    int width = 0, height = 0; // son yüklenen kare
+
+    // Private
+    bool          ok = false;
+    GLuint        program = 0;
+    GLuint        tex[3] = { 0, 0, 0 }; // Y, U (nv12: UV), V
+    int           tex_w[3] = { 0, 0, 0 }, tex_h[3] = { 0, 0, 0 };
+    GLint         tex_fmt[3] = { 0, 0, 0 }; // internal format (format değişince yeniden ayrılır)
+    GLint         loc_tex[3] = { -1, -1, -1 };
+    GLint         loc_range = -1, loc_coef = -1, loc_nv12 = -1;
+    AVPixelFormat fmt = AV_PIX_FMT_NONE;
+    int           color_key = -1; // katsayıların kurulduğu format/matris/aralık
+};
+
+// Shader'ı derler; GL 2.0 yoksa ya da derleme başarısızsa false (çağıran
+// sabit fonksiyonlu RGBA texture yoluna düşer).
+bool gl_yuv_init(GlYuvRenderer* r);
+
+// Kareyi düzlem texture'larına yükler; `pbo` verilirse düzlemler önce halkadaki
+// PBO'ya kopyalanır ve texture yüklemesi oradan asenkron yapılır. Format
+// desteklenmiyorsa false (o kare CPU'da dönüştürülmeli).
+bool gl_yuv_supported(const AVFrame* frame);
+bool gl_yuv_upload(GlYuvRenderer* r, const AVFrame* frame, GlPboRing* pbo = nullptr);
+
+// Son yüklenen kareyi (x0,y0)-(x1,y1) dikdörtgenine çizer; sonra sabit
+// fonksiyonlu duruma (program 0, texture unit 0) döner.
+void gl_yuv_draw(GlYuvRenderer* r, int x0, int y0, int x1, int y1);
+
+void gl_yuv_destroy(GlYuvRenderer* r);
+
+#endif
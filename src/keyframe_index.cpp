@@ -0,0 +1,352 @@
+#include "keyframe_index.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const size_t   PUBLISH_BATCH = 256; // bu kadar keyframe'de bir paylaşılan listeye aktar
+static const char     SIDECAR_MAGIC[8] = { 'V', 'A', 'K', 'F', 'I', 'D', 'X', 0 };
+static const uint32_t SIDECAR_VERSION  = 2;  // format değişince artır, eski dosyalar yeniden kurulur (2: yarım taramalar kaydedilmez)
+
+struct SidecarHeader {
+    char              magic[8];
+    uint32_t          version;
+    uint32_t          entry_size;
+    int64_t           file_size;
+    int64_t           file_mtime;
+    uint64_t          entry_count;
+    KeyframeIndexInfo info;
+};
+
+// --- Sidecar dosyası ---
+
+static bool file_identity(const char* filename, int64_t* size, int64_t* mtime) {
+#ifdef _WIN32
+    struct _stat64 sb;
+    if (_stat64(filename, &sb) != 0) return false;
+#else
+    struct stat sb;
+    if (stat(filename, &sb) != 0) return false;
+#endif
+    *size  = (int64_t)sb.st_size;
+    *mtime = (int64_t)sb.st_mtime;
+    return true;
+}
+
+static std::string cache_dir() {
+    std::string dir;
+#if defined(_WIN32)
+    if (const char* d = std::getenv("LOCALAPPDATA")) dir = std::string(d) + "\\video-app";
+#elif defined(__APPLE__)
+    if (const char* h = std::getenv("HOME")) dir = std::string(h) + "/Library/Caches/video-app";
+#else
+    if (const char* x = std::getenv("XDG_CACHE_HOME")) dir = std::string(x) + "/video-app";
+    else if (const char* h = std::getenv("HOME")) dir = std::string(h) + "/.cache/video-app";
+#endif
+    return dir;
+}
+
+static void make_dirs(const std::string& dir) {
+    for (size_t i = 1; i <= dir.size(); ++i) {
+        if (i < dir.size() && dir[i] != '/' && dir[i] != '\\') continue;
+        std::string part = dir.substr(0, i);
+#ifdef _WIN32
+        _mkdir(part.c_str());
+#else
+        mkdir(part.c_str(), 0755);
+#endif
+    }
+}
+
+// <cache>/<fnv1a(mutlak yol, boyut, mtime)>.kfidx
+static std::string sidecar_path(const char* filename, int64_t size, int64_t mtime) {
+    std::string dir = cache_dir();
+    if (dir.empty()) return std::string();
+#ifdef _WIN32
+    char abs[MAX_PATH];
+    const char* full = _fullpath(abs, filename, MAX_PATH) ? abs : filename;
+#else
+    char abs[PATH_MAX];
+    const char* full = realpath(filename, abs) ? abs : filename;
+#endif
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* p, size_t n) {
+        for (size_t i = 0; i < n; ++i) { h ^= ((const uint8_t*)p)[i]; h *= 1099511628211ull; }
+    };
+    mix(full, std::strlen(full));
+    mix(&size, sizeof(size));
+    mix(&mtime, sizeof(mtime));
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.kfidx", (unsigned long long)h);
+    return dir + "/" + name;
+}
+
+static bool map_file(const std::string& path, void** base, size_t* size) {
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER len;
+    HANDLE m = nullptr;
+    if (GetFileSizeEx(f, &len) && len.QuadPart > 0)
+        m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(f);
+    if (!m) return false;
+    *base = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(m);
+    *size = (size_t)len.QuadPart;
+    return *base != nullptr;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat sb;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &sb) == 0 && sb.st_size > 0)
+        p = mmap(nullptr, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    *base = p;
+    *size = (size_t)sb.st_size;
+    return true;
+#endif
+}
+
+static void unmap_file(void* base, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(base);
+#else
+    munmap(base, size);
+#endif
+}
+
+static bool entry_pts_less(const KeyframeIndexEntry& a, const KeyframeIndexEntry& b) {
+    return a.pts < b.pts;
+}
+
+bool keyframe_index_load(KeyframeIndex* idx, const char* filename) {
+    int64_t size = 0, mtime = 0;
+    if (!file_identity(filename, &size, &mtime)) return false;
+    std::string path = sidecar_path(filename, size, mtime);
+    if (path.empty()) return false;
+
+    void* base = nullptr;
+    size_t map_size = 0;
+    if (!map_file(path, &base, &map_size)) return false;
+
+    const SidecarHeader* hdr = (const SidecarHeader*)base;
+    bool ok = map_size >= sizeof(SidecarHeader) &&
+              std::memcmp(hdr->magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC)) == 0 &&
+              hdr->version == SIDECAR_VERSION &&
+              hdr->entry_size == sizeof(KeyframeIndexEntry) &&
+              hdr->file_size == size && hdr->file_mtime == mtime &&
+              hdr->entry_count > 0 &&
+              // Çarpım taşmasın: önce sayı dosyaya sığıyor mu
+              hdr->entry_count <= (map_size - sizeof(SidecarHeader)) / sizeof(KeyframeIndexEntry) &&
+              map_size == sizeof(SidecarHeader) + hdr->entry_count * sizeof(KeyframeIndexEntry);
+    // lookup upper_bound kullanır: tablo pts'e göre sıralı olmalı
+    if (ok) {
+        const KeyframeIndexEntry* e = (const KeyframeIndexEntry*)(hdr + 1);
+        ok = std::is_sorted(e, e + hdr->entry_count, entry_pts_less);
+    }
+    if (!ok) {
+        // Eski sürüm ya da bozuk: sil, tarama yeniden kurar
+        unmap_file(base, map_size);
+        std::remove(path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(idx->mtx);
+    idx->path         = filename;
+    idx->stream_index = hdr->info.stream_index;
+    idx->file_size    = size;
+    idx->file_mtime   = mtime;
+    idx->info         = hdr->info;
+    idx->map_base     = base;
+    idx->map_size     = map_size;
+    idx->mapped       = (const KeyframeIndexEntry*)(hdr + 1);
+    idx->mapped_count = (size_t)hdr->entry_count;
+    idx->covered_pts  = hdr->info.end_pts;
+    idx->complete     = true;
+    return true;
+}
+
+void keyframe_index_unload(KeyframeIndex* idx) {
+    std::lock_guard<std::mutex> lock(idx->mtx);
+    if (idx->map_base) unmap_file(idx->map_base, idx->map_size);
+    idx->map_base = nullptr;
+    idx->map_size = 0;
+    idx->mapped = nullptr;
+    idx->mapped_count = 0;
+    idx->entries.clear();
+    idx->covered_pts = AV_NOPTS_VALUE;
+    idx->complete = false;
+}
+
+bool keyframe_index_matches(const KeyframeIndex* idx, const AVFormatContext* fmt, int stream_index) {
+    const KeyframeIndexInfo& in = idx->info;
+    if (stream_index < 0 || in.nb_streams != (int)fmt->nb_streams || in.stream_index != stream_index)
+        return false;
+    const AVStream* s = fmt->streams[stream_index];
+    const AVCodecParameters* par = s->codecpar;
+    if (in.codec_id != (int)par->codec_id) return false;
+    if (in.tb_num != s->time_base.num || in.tb_den != s->time_base.den) return false;
+    if (par->codec_type == AVMEDIA_TYPE_VIDEO && (in.width != par->width || in.height != par->height))
+        return false;
+    return true;
+}
+
+static void save_sidecar(KeyframeIndex* idx) {
+    std::string path = sidecar_path(idx->path.c_str(), idx->file_size, idx->file_mtime);
+    if (path.empty() || idx->entries.empty()) return;
+    make_dirs(cache_dir());
+
+    SidecarHeader hdr = {};
+    std::memcpy(hdr.magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+    hdr.version     = SIDECAR_VERSION;
+    hdr.entry_size  = sizeof(KeyframeIndexEntry);
+    hdr.file_size   = idx->file_size;
+    hdr.file_mtime  = idx->file_mtime;
+    hdr.entry_count = idx->entries.size();
+    hdr.info        = idx->info;
+
+    // Yarım dosya kalmasın: önce geçici dosyaya yaz, sonra yerine taşı
+    std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return;
+    bool ok = std::fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              std::fwrite(idx->entries.data(), sizeof(KeyframeIndexEntry), idx->entries.size(), f) ==
+                  idx->entries.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (ok) {
+        std::remove(path.c_str()); // Windows'ta rename hedefin üzerine yazmaz
+        ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+    if (!ok) std::remove(tmp.c_str());
+}
+
+// --- Tarama ---
+
+static void publish(KeyframeIndex* idx, std::vector<KeyframeIndexEntry>* batch, int64_t covered) {
+    std::lock_guard<std::mutex> lock(idx->mtx);
+    for (const KeyframeIndexEntry& e : *batch) {
+        // B-frame'siz akışlarda keyframe'ler zaten artan sırada gelir
+        auto it = std::upper_bound(idx->entries.begin(), idx->entries.end(), e, entry_pts_less);
+        idx->entries.insert(it, e);
+    }
+    batch->clear();
+    if (covered != AV_NOPTS_VALUE) idx->covered_pts = covered;
+}
+
+static void index_loop(KeyframeIndex* idx) {
+    AVFormatContext* fmt = nullptr;
+    if (avformat_open_input(&fmt, idx->path.c_str(), nullptr, nullptr) < 0) {
+        std::printf("index: couldn't open '%s'\n", idx->path.c_str());
+        return;
+    }
+    if (avformat_find_stream_info(fmt, nullptr) < 0 ||
+        idx->stream_index >= (int)fmt->nb_streams) {
+        std::printf("index: stream info mismatch, index disabled\n");
+        avformat_close_input(&fmt);
+        return;
+    }
+    // Diğer stream'lerin paketlerini demuxer hiç birleştirmesin
+    for (unsigned i = 0; i < fmt->nb_streams; ++i)
+        if ((int)i != idx->stream_index) fmt->streams[i]->discard = AVDISCARD_ALL;
+
+    AVPacket* pkt = av_packet_alloc();
+    std::vector<KeyframeIndexEntry> batch;
+    int64_t covered = AV_NOPTS_VALUE, start = AV_NOPTS_VALUE, end = AV_NOPTS_VALUE;
+    int ret = 0;
+    while (pkt && !idx->quit.load(std::memory_order_relaxed)) {
+        ret = av_read_frame(fmt, pkt);
+        if (ret < 0) break;
+        if (pkt->stream_index == idx->stream_index) {
+            int64_t ts = pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts;
+            if (ts != AV_NOPTS_VALUE) {
+                if (covered == AV_NOPTS_VALUE || ts > covered) covered = ts;
+                if (start == AV_NOPTS_VALUE || ts < start) start = ts;
+                int64_t e = ts + (pkt->duration > 0 ? pkt->duration : 0);
+                if (end == AV_NOPTS_VALUE || e > end) end = e;
+                if (pkt->flags & AV_PKT_FLAG_KEY) {
+                    batch.push_back({ ts, pkt->dts, pkt->pos, AV_PKT_FLAG_KEY, 0 });
+                    if (batch.size() >= PUBLISH_BATCH) publish(idx, &batch, covered);
+                }
+            }
+        }
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+
+    if (!idx->quit.load()) {
+        publish(idx, &batch, covered);
+        const AVStream* s = fmt->streams[idx->stream_index];
+        KeyframeIndexInfo& in = idx->info;
+        in.nb_streams   = (int32_t)fmt->nb_streams;
+        in.stream_index = idx->stream_index;
+        in.codec_id     = (int32_t)s->codecpar->codec_id;
+        in.width        = s->codecpar->width;
+        in.height       = s->codecpar->height;
+        in.tb_num       = s->time_base.num;
+        in.tb_den       = s->time_base.den;
+        in.start_pts    = start;
+        in.end_pts      = end;
+        // Okuma hatası: taranan kısım kullanılır, gerisi av_seek_frame'e kalır
+        if (ret == AVERROR_EOF) idx->complete.store(true);
+        else std::printf("index: scan stopped early (%d), partial index\n", ret);
+        // Yarım tarama kaydedilmez; tarama sırasında dosya değiştiyse de
+        int64_t size = 0, mtime = 0;
+        if (ret == AVERROR_EOF && file_identity(idx->path.c_str(), &size, &mtime) &&
+            size == idx->file_size && mtime == idx->file_mtime)
+            save_sidecar(idx);
+    }
+    avformat_close_input(&fmt);
+}
+
+void keyframe_index_start(KeyframeIndex* idx, const char* filename, int stream_index) {
+    if (idx->complete.load()) return; // sidecar'dan yüklendi
+    idx->path = filename;
+    idx->stream_index = stream_index;
+    idx->quit = false;
+    if (!file_identity(filename, &idx->file_size, &idx->file_mtime)) idx->file_size = -1;
+    idx->thread = std::thread(index_loop, idx);
+}
+
+void keyframe_index_stop(KeyframeIndex* idx) {
+    idx->quit = true;
+    if (idx->thread.joinable()) idx->thread.join();
+}
+
+bool keyframe_index_lookup(KeyframeIndex* idx, int64_t ts, KeyframeIndexEntry* out) {
+    std::lock_guard<std::mutex> lock(idx->mtx);
+    const KeyframeIndexEntry* first = idx->mapped ? idx->mapped : idx->entries.data();
+    const KeyframeIndexEntry* last  = first + (idx->mapped ? idx->mapped_count : idx->entries.size());
+    if (first == last) return false;
+    if (!idx->complete.load() && (idx->covered_pts == AV_NOPTS_VALUE || ts > idx->covered_pts))
+        return false;
+
+    KeyframeIndexEntry key = { ts, 0, 0, 0, 0 };
+    const KeyframeIndexEntry* it = std::upper_bound(first, last, key, entry_pts_less);
+    if (it != first) --it; // ts öncesindeki son keyframe (yoksa ilki)
+    *out = *it;
+    return true;
+}
+
+double keyframe_index_duration_sec(const KeyframeIndex* idx) {
+    const KeyframeIndexInfo& in = idx->info;
+    if (!idx->complete.load() || in.tb_den == 0 ||
+        in.start_pts == AV_NOPTS_VALUE || in.end_pts == AV_NOPTS_VALUE)
+        return 0.0;
+    return (in.end_pts - in.start_pts) * (double)in.tb_num / (double)in.tb_den;
+}
@@ -0,0 +1,75 @@
+#ifndef keyframe_index_hpp
+#define keyframe_index_hpp
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Seek stream'inin keyframe'leri (stream time_base). Sadece keyframe'ler
+// tutulur; `flags` AV_PKT_FLAG_KEY içerir. Sidecar dosyada da bu düzende durur.
+struct KeyframeIndexEntry {
+    int64_t pts;
+    int64_t dts;
+    int64_t pos;   // byte offset, bilinmiyorsa -1
+    int32_t flags;
+    int32_t reserved;
+};
+
+// Sidecar'da saklanan stream parametreleri (reopen'da dosyayla karşılaştırılır)
+struct KeyframeIndexInfo {
+    int32_t nb_streams;
+    int32_t stream_index;
+    int32_t codec_id;
+    int32_t width, height;   // video
+    int32_t tb_num, tb_den;
+    int32_t reserved;
+    int64_t start_pts;       // taranan ilk pts
+    int64_t end_pts;         // son paketin bitişi (pts + duration)
+};
+
+// Açılıştan sonra arka planda, ayrı bir AVFormatContext ile dosya baştan sona
+// okunarak doldurulur. Tamamlanmadan da kullanılabilir: o ana kadar taranan
+// bölüm için lookup geçerlidir. Tamamlanınca cache dizinine (yol + boyut +
+// mtime anahtarlı) yazılır; sonraki açılışta mmap ile yüklenir.
+struct KeyframeIndex {
+    // Private
+    std::string                     path;
+    int                             stream_index = -1;
+    int64_t                         file_size = -1, file_mtime = 0;
+    KeyframeIndexInfo               info = {};
+    std::vector<KeyframeIndexEntry> entries;     // pts'e göre sıralı
+    int64_t                         covered_pts = AV_NOPTS_VALUE; // taranan en büyük pts
+    const KeyframeIndexEntry*       mapped = nullptr; // sidecar'dan yüklendiyse
+    size_t                          mapped_count = 0;
+    void*                           map_base = nullptr;
+    size_t                          map_size = 0;
+    std::mutex                      mtx;
+    std::atomic<bool>               complete{false};
+    std::atomic<bool>               quit{false};
+    std::thread                     thread;
+};
+
+// Geçerli (sürüm, boyut, mtime tutan) bir sidecar varsa mmap eder; indeks
+// tamamlanmış sayılır ve keyframe_index_start tarama yapmaz.
+bool keyframe_index_load(KeyframeIndex* idx, const char* filename);
+// Yüklenen indeks açılan dosyanın stream'leriyle uyuşuyor mu
+bool keyframe_index_matches(const KeyframeIndex* idx, const AVFormatContext* fmt, int stream_index);
+void keyframe_index_unload(KeyframeIndex* idx);
+
+void keyframe_index_start(KeyframeIndex* idx, const char* filename, int stream_index);
+void keyframe_index_stop(KeyframeIndex* idx);
+
+// `ts` (stream time_base) anında ya da öncesindeki son keyframe. İndeks bu
+// noktaya henüz ulaşmadıysa false döner (çağıran normal seek'e düşer).
+bool keyframe_index_lookup(KeyframeIndex* idx, int64_t ts, KeyframeIndexEntry* out);
+
+// Tamamlanmış indeksin kapsadığı süre (saniye, tahmin değil); yoksa <=0.
+double keyframe_index_duration_sec(const KeyframeIndex* idx);
+
+#endif
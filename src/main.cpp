@@ -3,6 +3,8 @@
 #include "player.hpp"
 #include "portable-file-dialogs.h"
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -19,9 +21,100 @@ static std::string pick_video_path() {
     std::string path; std::cout << "Video yolu girin: "; std::getline(std::cin, path); return path;
 }
 
+static void print_usage(const char* argv0) {
+    std::printf("Usage: %s [options] [video]\n"
+                "  --threads <auto|N>                 video decoder thread count\n"
+                "  --thread-type <auto|frame|slice>   video decoder threading mode\n"
+                "  --fast-seek                        seek to the nearest keyframe only\n"
+                "  --convert-threads <auto|N>         threads for YUV -> RGB conversion\n"
+                "  --swscale                          always convert with swscale\n"
+                "  --frame-pool <auto|off|N>          decoder frame buffer pool capacity\n"
+                "  --scale-to-display                 convert frames at the drawn size, not the source size\n"
+                "  --cpu-convert                      convert to RGB on the CPU instead of in a shader\n"
+                "  --no-pbo                           upload textures directly instead of through PBOs\n"
+                "  --sync <audio|video|ext>           master clock; video/ext play without audio\n"
+                "                                     (files without audio always use ext)\n"
+                "  --audio-only                       don't decode video (A key toggles; automatic while minimized)\n"
+                "  --stats                            show the stats overlay at start (S key toggles)\n"
+                "  --trace <file>                     record stage timings, write Chrome trace JSON on exit\n"
+                "                                     (T key: start recording / write the trace)\n",
+                argv0);
+}
+
+// Tanınmayan argüman/değer için false döner
+static bool parse_args(int argc, const char** argv, PlayerOptions* opts, std::string* path) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!std::strcmp(a, "--threads") && val) {
+            if (!std::strcmp(val, "auto")) opts->video_decode.thread_count = 0;
+            else {
+                int n = std::atoi(val);
+                if (n < 1) return false;
+                opts->video_decode.thread_count = n;
+            }
+            ++i;
+        } else if (!std::strcmp(a, "--thread-type") && val) {
+            if      (!std::strcmp(val, "auto"))  opts->video_decode.thread_mode = VIDEO_THREADS_AUTO;
+            else if (!std::strcmp(val, "frame")) opts->video_decode.thread_mode = VIDEO_THREADS_FRAME;
+            else if (!std::strcmp(val, "slice")) opts->video_decode.thread_mode = VIDEO_THREADS_SLICE;
+            else return false;
+            ++i;
+        } else if (!std::strcmp(a, "--convert-threads") && val) {
+            if (!std::strcmp(val, "auto")) opts->video_decode.convert_threads = 0;
+            else {
+                int n = std::atoi(val);
+                if (n < 1) return false;
+                opts->video_decode.convert_threads = n;
+            }
+            ++i;
+        } else if (!std::strcmp(a, "--frame-pool") && val) {
+            if      (!std::strcmp(val, "auto")) opts->video_decode.frame_pool = 0;
+            else if (!std::strcmp(val, "off"))  opts->video_decode.frame_pool = -1;
+            else {
+                int n = std::atoi(val);
+                if (n < 1) return false;
+                opts->video_decode.frame_pool = n;
+            }
+            ++i;
+        } else if (!std::strcmp(a, "--trace") && val) {
+            opts->trace_path = val;
+            ++i;
+        } else if (!std::strcmp(a, "--sync") && val) {
+            if      (!std::strcmp(val, "audio")) opts->sync = MASTER_CLOCK_AUDIO;
+            else if (!std::strcmp(val, "video")) opts->sync = MASTER_CLOCK_VIDEO;
+            else if (!std::strcmp(val, "ext"))   opts->sync = MASTER_CLOCK_EXTERNAL;
+            else return false;
+            ++i;
+        } else if (!std::strcmp(a, "--audio-only")) {
+            opts->audio_only = true;
+        } else if (!std::strcmp(a, "--stats")) {
+            opts->show_stats = true;
+        } else if (!std::strcmp(a, "--swscale")) {
+            opts->video_decode.simd_convert = false;
+        } else if (!std::strcmp(a, "--no-pbo")) {
+            opts->pbo_upload = false;
+        } else if (!std::strcmp(a, "--cpu-convert")) {
+            opts->gpu_yuv = false;
+        } else if (!std::strcmp(a, "--scale-to-display")) {
+            opts->video_decode.scale_to_display = true;
+        } else if (!std::strcmp(a, "--fast-seek")) {
+            opts->video_decode.accurate_seek = false;
+        } else if (a[0] == '-' && a[1] == '-') {
+            return false;
+        } else {
+            *path = a;
+        }
+    }
+    return true;
+}
+
 int main(int argc, const char** argv) {
-    std::string path = (argc >= 2) ? argv[1] : pick_video_path();
+    PlayerOptions opts;
+    std::string path;
+    if (!parse_args(argc, argv, &opts, &path)) { print_usage(argv[0]); return 1; }
+    if (path.empty()) path = pick_video_path();
     if (path.empty()) { std::fprintf(stderr, "Dosya seçilmedi.\n"); return 1; }
     std::printf("Playing: %s\n", path.c_str());
-    return run_player(path.c_str());
+    return run_player(path.c_str(), opts);
 }
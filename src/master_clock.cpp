@@ -0,0 +1,41 @@
+#include "master_clock.hpp"
+#include "stage_clock.hpp"
+
+void master_clock_init(MasterClock* c, MasterClockType type, AudioOutputState* audio, double start_pts) {
+    *c = MasterClock();
+    c->type = type;
+    c->audio = audio;
+    c->base_pts = start_pts;
+}
+
+double master_clock_get(const MasterClock* c) {
+    if (c->type == MASTER_CLOCK_AUDIO) return audio_output_clock(c->audio);
+    if (c->paused) return c->base_pts;
+    return c->base_pts + (stage_clock_now() - c->base_time);
+}
+
+void master_clock_pause(MasterClock* c, bool paused) {
+    if (c->type == MASTER_CLOCK_AUDIO) { audio_output_pause(c->audio, paused); return; }
+    if (paused == c->paused) return;
+    if (paused) c->base_pts = master_clock_get(c); // durduğu yerde kalır
+    c->base_time = stage_clock_now();
+    c->paused = paused;
+}
+
+void master_clock_set(MasterClock* c, double pts) {
+    if (c->type == MASTER_CLOCK_AUDIO) return;
+    c->base_pts = pts;
+    c->base_time = stage_clock_now();
+}
+
+void master_clock_presented(MasterClock* c, double pts) {
+    if (c->type == MASTER_CLOCK_VIDEO && !c->paused) master_clock_set(c, pts);
+}
+
+const char* master_clock_name(MasterClockType type) {
+    switch (type) {
+        case MASTER_CLOCK_AUDIO: return "audio";
+        case MASTER_CLOCK_VIDEO: return "video";
+        default:                 return "external";
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef master_clock_hpp
+#define master_clock_hpp
+
+#include "audio_output.hpp"
+
+// Kare zamanlamasının izlediği ana saat (saniye, mutlak pts ekseni).
+//  AUDIO:    ses cihazına verilen örnekler (audio_output_clock)
+//  VIDEO:    son gösterilen karenin pts'i + o andan beri geçen süre; decode
+//            geride kalırsa kare atılmaz, oynatma yavaşlar
+//  EXTERNAL: steady_clock; decode geride kalırsa geç kareler atılır
+// VIDEO/EXTERNAL'da ses açılmaz (sessiz klipler, --sync video|ext).
+enum MasterClockType {
+    MASTER_CLOCK_AUDIO,
+    MASTER_CLOCK_VIDEO,
+    MASTER_CLOCK_EXTERNAL,
+};
+
+struct MasterClock {
+    // Public
+    MasterClockType type = MASTER_CLOCK_EXTERNAL;
+
+    // Private
+    AudioOutputState* audio = nullptr; // AUDIO
+    double base_pts = 0.0;  // base_time anındaki değer
+    double base_time = 0.0; // stage_clock_now()
+    bool   paused = true;
+};
+
+// AUDIO için `audio` açık bir çıkış olmalı; diğerleri duraklatılmış ve
+// `start_pts`'te başlar.
+void   master_clock_init(MasterClock* c, MasterClockType type, AudioOutputState* audio, double start_pts = 0.0);
+double master_clock_get(const MasterClock* c);
+void   master_clock_pause(MasterClock* c, bool paused);
+// Seek sonrası: VIDEO/EXTERNAL saati `pts`'e taşır (AUDIO'da ses flush'ı belirler)
+void   master_clock_set(MasterClock* c, double pts);
+// Her sunulan karede; VIDEO saati karenin pts'ine oturtur
+void   master_clock_presented(MasterClock* c, double pts);
+const char* master_clock_name(MasterClockType type);
+
+#endif
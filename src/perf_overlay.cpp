@@ -0,0 +1,105 @@
+#include "perf_overlay.hpp"
+#include "imgui.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+static const int   HIST_BINS = 25;
+static const float HIST_BIN_MS = 2.0f; // son bin: >= 48 ms
+
+void perf_overlay_toggle(PerfOverlay* p) {
+    p->visible = !p->visible;
+    if (!p->visible) return;
+    p->frame_ms.clear(); p->decode_ms.clear(); p->convert_ms.clear();
+    p->upload_ms.clear(); p->drift_ms.clear();
+    p->last_frame_t = 0.0; p->next_drift_t = 0.0;
+    p->drift_sum = 0.0; p->drift_n = 0;
+}
+
+void perf_overlay_frame(PerfOverlay* p, double now) {
+    if (p->last_frame_t > 0.0) p->frame_ms.push((float)((now - p->last_frame_t) * 1e3));
+    p->last_frame_t = now;
+}
+
+void perf_overlay_break(PerfOverlay* p) {
+    p->last_frame_t = 0.0;
+}
+
+void perf_overlay_presented(PerfOverlay* p, double now, double decode_sec,
+                            double convert_sec, double upload_sec, double drift_sec) {
+    p->decode_ms.push((float)(decode_sec * 1e3));
+    p->convert_ms.push((float)(convert_sec * 1e3));
+    p->upload_ms.push((float)(upload_sec * 1e3));
+    p->drift_sum += drift_sec; p->drift_n++;
+    if (now >= p->next_drift_t) {
+        p->drift_ms.push((float)(p->drift_sum / p->drift_n * 1e3));
+        p->drift_sum = 0.0; p->drift_n = 0;
+        p->next_drift_t = now + 1.0 / PERF_DRIFT_HZ;
+    }
+}
+
+template <int N>
+static void avg_max(const PerfRing<N>& r, float* avg, float* mx) {
+    double sum = 0.0; float m = 0.0f;
+    for (int i = 0; i < r.count; ++i) { sum += r.v[i]; m = std::max(m, r.v[i]); }
+    *avg = r.count ? (float)(sum / r.count) : 0.0f;
+    *mx = m;
+}
+
+// Halkadaki en eski örnekten başlayarak çizilecek offset
+template <int N>
+static int plot_offset(const PerfRing<N>& r) { return r.count < N ? 0 : r.head; }
+
+void perf_overlay_draw(PerfOverlay* p, const PerfSnapshot& s) {
+    ImGui::SetNextWindowBgAlpha(0.8f);
+    ImGui::SetNextWindowPos(ImVec2(8, 8), ImGuiCond_FirstUseEver);
+    ImGuiWindowFlags flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings |
+                             ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+    if (!ImGui::Begin("Stats (S)", &p->visible, flags)) { ImGui::End(); return; }
+
+    // Kare süresi: yüzdelikler ve 2 ms'lik histogram (sadece çizimde hesaplanır)
+    const auto& fr = p->frame_ms;
+    float sorted[PERF_FRAME_SAMPLES];
+    std::copy(fr.v, fr.v + fr.count, sorted);
+    std::sort(sorted, sorted + fr.count);
+    auto pct = [&](float q) { return fr.count ? sorted[(int)std::lround(q * (fr.count - 1))] : 0.0f; };
+    float hist[HIST_BINS] = { 0 };
+    for (int i = 0; i < fr.count; ++i)
+        hist[std::min(HIST_BINS - 1, (int)(fr.v[i] / HIST_BIN_MS))] += 1.0f;
+    ImGui::Text("frame   p50 %5.1f  p95 %5.1f  p99 %5.1f  max %5.1f ms",
+                pct(0.50f), pct(0.95f), pct(0.99f), fr.count ? sorted[fr.count - 1] : 0.0f);
+    ImGui::PlotHistogram("##frame_hist", hist, HIST_BINS, 0, "frame time, 0-50 ms",
+                         0.0f, FLT_MAX, ImVec2(320, 60));
+
+    float avg, mx;
+    avg_max(p->decode_ms, &avg, &mx);
+    if (s.decode_codec) ImGui::Text("decode  avg %6.2f  max %6.2f ms  (%s, %d %s thread(s))", avg, mx,
+                                    s.decode_codec, s.decode_threads, s.decode_threading);
+    else                ImGui::Text("decode  avg %6.2f  max %6.2f ms", avg, mx);
+    avg_max(p->convert_ms, &avg, &mx);
+    if (s.convert_w > 0) ImGui::Text("convert avg %6.2f  max %6.2f ms  (%dx%d, %s)", avg, mx, s.convert_w,
+                                     s.convert_h, s.convert_kernel ? s.convert_kernel : "-");
+    else                 ImGui::Text("convert avg %6.2f  max %6.2f ms  (shader)", avg, mx);
+    avg_max(p->upload_ms, &avg, &mx);
+    ImGui::Text("upload  avg %6.2f  max %6.2f ms", avg, mx);
+
+    ImGui::Separator();
+    ImGui::Text("audio queued   %6.0f ms", s.audio_queued_ms);
+    ImGui::Text("video ready    %3d / %d frames", s.video_ready, s.video_capacity);
+    ImGui::Text("packets        video %d  audio %d", s.video_packets, s.audio_packets);
+    ImGui::Text("presented %lld  dropped %lld  late %lld  dup %lld",
+                (long long)s.presented, (long long)s.dropped, (long long)s.late, (long long)s.duplicated);
+
+    // A/V drift: ölçek en az +/-20 ms, büyük sapmada genişler (0 ortada)
+    ImGui::Separator();
+    const auto& dr = p->drift_ms;
+    float range = 20.0f;
+    for (int i = 0; i < dr.count; ++i) range = std::max(range, std::fabs(dr.v[i]));
+    char label[64];
+    const float last = dr.count ? dr.v[(dr.head + PERF_DRIFT_SAMPLES - 1) % PERF_DRIFT_SAMPLES] : 0.0f;
+    std::snprintf(label, sizeof(label), "A/V drift %+.1f ms (+/-%.0f)", last, range);
+    ImGui::PlotLines("##drift", dr.v, dr.count, plot_offset(dr), label, -range, range, ImVec2(320, 60));
+
+    ImGui::End();
+}
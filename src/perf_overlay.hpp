@@ -0,0 +1,57 @@
+#ifndef perf_overlay_hpp
+#define perf_overlay_hpp
+
+#include <cstdint>
+
+// Oynatma sırasında açılıp kapanan ImGui istatistik paneli. Tüm geçmiş sabit
+// boyutlu halkalarda (uzun testlerde büyümez). Gizliyken çağıran hiçbir
+// fonksiyonu çağırmaz: örnekleme de çizim de sadece `visible` iken yapılır.
+static const int PERF_FRAME_SAMPLES = 512; // son kareler (30 fps'te ~17 s)
+static const int PERF_DRIFT_HZ      = 10;
+static const int PERF_DRIFT_SAMPLES = 30 * PERF_DRIFT_HZ; // son 30 s
+
+template <int N>
+struct PerfRing {
+    float v[N];
+    int   head = 0, count = 0; // head: sıradaki yazılacak
+    void push(float x) { v[head] = x; head = (head + 1) % N; if (count < N) count++; }
+    void clear() { head = count = 0; }
+};
+
+struct PerfOverlay {
+    // Public
+    bool visible = false;
+
+    // Private
+    PerfRing<PERF_FRAME_SAMPLES> frame_ms;   // art arda iki swap arası
+    PerfRing<PERF_FRAME_SAMPLES> decode_ms, convert_ms, upload_ms; // sunulan kare başına
+    PerfRing<PERF_DRIFT_SAMPLES> drift_ms;   // PERF_DRIFT_HZ ile ortalama (clock - pts)
+    double last_frame_t = 0.0;               // 0: sonraki aralık ölçülmez
+    double next_drift_t = 0.0, drift_sum = 0.0;
+    int    drift_n = 0;
+};
+
+// Panelin her çizimde okuduğu anlık değerler (çağıran doldurur)
+struct PerfSnapshot {
+    double  audio_queued_ms = 0.0;
+    int     video_ready = 0, video_capacity = 0;
+    int     video_packets = 0, audio_packets = 0;
+    int     convert_w = 0, convert_h = 0; // CPU dönüşüm boyutu; 0: shader yolu
+    const char* convert_kernel = nullptr; // CPU dönüşüm yolu (avx2, swscale...)
+    const char* decode_codec = nullptr;   // decoder adı ve threading'i
+    const char* decode_threading = nullptr;
+    int         decode_threads = 0;
+    int64_t presented = 0, dropped = 0, late = 0, duplicated = 0;
+};
+
+// Gösterirken geçmiş sıfırlanır
+void perf_overlay_toggle(PerfOverlay* p);
+// Her swap'ta; pause/seek sonrası ilk aralık perf_overlay_break ile atlanır
+void perf_overlay_frame(PerfOverlay* p, double now);
+void perf_overlay_break(PerfOverlay* p);
+// Sunulan her kare için (süreler saniye, drift: clock - pts)
+void perf_overlay_presented(PerfOverlay* p, double now, double decode_sec,
+                            double convert_sec, double upload_sec, double drift_sec);
+void perf_overlay_draw(PerfOverlay* p, const PerfSnapshot& s);
+
+#endif
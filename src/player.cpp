@@ -1,6 +1,15 @@
 #include "player.hpp"
 #include "video_reader.hpp"
+#include "video_decoder.hpp"
 #include "sound_reader.hpp"
+#include "audio_output.hpp"
+#include "frame_scheduler.hpp"
+#include "frame_pool.hpp"
+#include "gl_pbo.hpp"
+#include "gl_yuv.hpp"
+#include "master_clock.hpp"
+#include "perf_overlay.hpp"
+#include "stage_trace.hpp"
 
 #include <GLFW/glfw3.h>
 #include <SDL2/SDL.h>
@@ -8,6 +17,8 @@
 #include <cstdint>
 #include <algorithm>
 #include <string>
+#include <thread>
+#include <vector>
 
 // ImGui
 #include "imgui.h"
@@ -25,27 +36,40 @@ static inline std::string fmt_time(double sec) {
     else       std::snprintf(buf, sizeof(buf), "%02d:%02d", m, s);
     return buf;
 }
-static inline void apply_volume_s16(uint8_t* data, int nbytes, float vol01) {
-    if (!data) return;
-    if (vol01 < 0.f) vol01 = 0.f;
-    if (vol01 > 1.f) vol01 = 1.f;
-    int16_t* p = (int16_t*)data;
-    int count = nbytes / 2;
-    for (int i = 0; i < count; ++i) {
-        int v = (int)std::lround(p[i] * vol01);
-        if (v >  32767) v =  32767;
-        if (v < -32768) v = -32768;
-        p[i] = (int16_t)v;
-    }
-}
 
-int run_player(const char* filename) {
+// Render-on-demand: pencereye gelen her girdi/yeniden çizim olayını sayar.
+// Callback'ler ImGui'den önce kurulur, ImGui'nin GLFW backend'i onları da çağırır.
+static int g_window_events = 0;
+static void on_cursor(GLFWwindow*, double, double)        { ++g_window_events; }
+static void on_mouse(GLFWwindow*, int, int, int)          { ++g_window_events; }
+static void on_scroll(GLFWwindow*, double, double)        { ++g_window_events; }
+static void on_key(GLFWwindow*, int, int, int, int)       { ++g_window_events; }
+static void on_char(GLFWwindow*, unsigned int)            { ++g_window_events; }
+static void on_resize(GLFWwindow*, int, int)              { ++g_window_events; }
+static void on_refresh(GLFWwindow*)                       { ++g_window_events; }
+static void on_focus(GLFWwindow*, int)                    { ++g_window_events; }
+static void on_iconify(GLFWwindow*, int)                  { ++g_window_events; }
+
+int run_player(const char* filename, const PlayerOptions& opts) {
+    stage_trace_thread_name("render");
+    const char* trace_path = opts.trace_path ? opts.trace_path : "video-app-trace.json";
+    if (opts.trace_path) stage_trace_enable(true);
+
     // --- GLFW / OpenGL ---
     if (!glfwInit()) { std::printf("Couldn't init GLFW\n"); return 1; }
     GLFWwindow* window = glfwCreateWindow(960, 540, "Video Player", nullptr, nullptr);
     if (!window) { std::printf("Couldn't open window\n"); glfwTerminate(); return 1; }
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // VSYNC
+    glfwSetCursorPosCallback(window, on_cursor);
+    glfwSetMouseButtonCallback(window, on_mouse);
+    glfwSetScrollCallback(window, on_scroll);
+    glfwSetKeyCallback(window, on_key);
+    glfwSetCharCallback(window, on_char);
+    glfwSetFramebufferSizeCallback(window, on_resize);
+    glfwSetWindowRefreshCallback(window, on_refresh);
+    glfwSetWindowFocusCallback(window, on_focus);
+    glfwSetWindowIconifyCallback(window, on_iconify);
 
     // --- ImGui ---
     IMGUI_CHECKVERSION();
@@ -54,16 +78,24 @@ int run_player(const char* filename) {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL2_Init();
 
+    // --- Demuxer (dosya bir kez açılır, paketler stream'lere dağıtılır) ---
+    DemuxerState dmx{};
+    if (!demuxer_open(&dmx, filename)) {
+        demuxer_close(&dmx);
+        ImGui_ImplOpenGL2_Shutdown(); ImGui_ImplGlfw_Shutdown(); ImGui::DestroyContext();
+        glfwDestroyWindow(window); glfwTerminate(); return 1;
+    }
+
     // --- Video ---
     VideoReaderState vr{};
-    if (!video_reader_open(&vr, filename)) {
+    if (!video_reader_open(&vr, &dmx, opts.video_decode)) {
         std::printf("Couldn't open video file (video)\n");
+        demuxer_close(&dmx);
         ImGui_ImplOpenGL2_Shutdown(); ImGui_ImplGlfw_Shutdown(); ImGui::DestroyContext();
         glfwDestroyWindow(window); glfwTerminate(); return 1;
     }
     const int frame_width  = vr.width;
     const int frame_height = vr.height;
-    uint8_t* frame_data = new uint8_t[frame_width * frame_height * 4];
 
     // GL texture
     GLuint tex_handle = 0;
@@ -74,46 +106,57 @@ int run_player(const char* filename) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, frame_width, frame_height, 0,
+    // texture boyutu = dönüşüm boyutu (scale_to_display'de çizilen boyut, yoksa kaynak)
+    int tex_w = vr.out_width, tex_h = vr.out_height;
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tex_w, tex_h, 0,
                  GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
-    // --- SDL2 / Audio ---
-    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
-        std::printf("SDL_Init audio failed: %s\n", SDL_GetError());
-        delete[] frame_data; glDeleteTextures(1, &tex_handle);
-        video_reader_close(&vr);
-        ImGui_ImplOpenGL2_Shutdown(); ImGui_ImplGlfw_Shutdown(); ImGui::DestroyContext();
-        glfwDestroyWindow(window); glfwTerminate(); return 1;
-    }
+    // YUV düzlemleri + shader (RGB dönüşümü GPU'da); olmazsa RGBA texture yolu
+    GlYuvRenderer yuv_gl;
+    const bool use_gl_yuv = opts.gpu_yuv && gl_yuv_init(&yuv_gl);
+    bool yuv_shown = false; // texture'daki son kare shader yolundan mı
+    // Texture yüklemesi PBO halkası üzerinden (kare map edilmiş belleğe yazılır)
+    GlPboRing pbo;
+    const bool use_pbo = opts.pbo_upload && gl_pbo_init(&pbo, 2);
+    std::printf("render: %s, %s upload\n",
+                use_gl_yuv ? "YUV textures + GLSL conversion" : "RGBA texture (CPU conversion)",
+                use_pbo ? "PBO" : "direct");
 
+    // --- SDL2 / Audio ---
+    // Ses stream'i yoksa ya da açılamazsa video steady_clock'a göre oynar; ses
+    // hiç decode edilmez (SDL ses cihazı, ses thread'i ve ring kurulmaz, demuxer
+    // ses paketlerini okumaz).
+    MasterClockType clock_type = opts.sync;
     SoundReaderState sr{};
+    AudioOutputState ao{};
     const int AUDIO_SR = 48000, AUDIO_CH = 2;
-    if (!sound_reader_open(&sr, filename, AUDIO_SR, AUDIO_CH, AV_SAMPLE_FMT_S16)) {
-        std::printf("Couldn't open audio stream\n");
-        SDL_Quit(); delete[] frame_data; glDeleteTextures(1, &tex_handle);
-        video_reader_close(&vr);
-        ImGui_ImplOpenGL2_Shutdown(); ImGui_ImplGlfw_Shutdown(); ImGui::DestroyContext();
-        glfwDestroyWindow(window); glfwTerminate(); return 1;
-    }
-    SDL_AudioSpec want{}; want.freq=AUDIO_SR; want.channels=AUDIO_CH;
-    want.format=AUDIO_S16SYS; want.samples=1024; want.callback=nullptr;
-    SDL_AudioSpec have{}; SDL_AudioDeviceID dev = SDL_OpenAudioDevice(nullptr,0,&want,&have,0);
-    if (!dev) {
-        std::printf("SDL_OpenAudioDevice failed: %s\n", SDL_GetError());
-        sound_reader_close(&sr); SDL_Quit(); delete[] frame_data; glDeleteTextures(1, &tex_handle);
-        video_reader_close(&vr);
-        ImGui_ImplOpenGL2_Shutdown(); ImGui_ImplGlfw_Shutdown(); ImGui::DestroyContext();
-        glfwDestroyWindow(window); glfwTerminate(); return 1;
+    bool have_audio = false;
+    if (clock_type == MASTER_CLOCK_AUDIO && dmx.audio_stream_index >= 0) {
+        if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+            std::printf("SDL_Init audio failed: %s\n", SDL_GetError());
+        } else if (!sound_reader_open(&sr, &dmx, AUDIO_SR, AUDIO_CH, AV_SAMPLE_FMT_S16)) {
+            std::printf("Couldn't open audio stream\n");
+        } else if (!audio_output_open(&ao, &sr, 0.3)) { // audio decode thread + SDL callback (ring ~300ms)
+            audio_output_close(&ao);
+        } else {
+            have_audio = true;
+        }
+        if (!have_audio) { sound_reader_close(&sr); SDL_Quit(); }
     }
-    const int BYTES_PER_SEC = have.freq * have.channels * (SDL_AUDIO_BITSIZE(have.format)/8);
-
-    // --- Prebuffer ~300ms ---
-    double audio_pts_base = 0.0, audio_end_pts = 0.0; bool audio_started = false;
-    double file_start_sec = 0.0; bool have_file_start = false; // fixed file start
+    if (!have_audio && clock_type == MASTER_CLOCK_AUDIO) clock_type = MASTER_CLOCK_EXTERNAL;
+    MasterClock clock;
+    master_clock_init(&clock, clock_type, have_audio ? &ao : nullptr);
+    std::printf("clock: %s master%s\n", master_clock_name(clock_type), have_audio ? "" : ", no audio");
+    if (opts.audio_only && !have_audio) std::printf("audio-only: no audio, playing video\n");
+    demuxer_start(&dmx);
 
     // UI state
-    bool paused = false, prevSpace=false, prevLeft=false, prevRight=false;
+    bool paused = false, prevSpace=false, prevLeft=false, prevRight=false, prevT=false, prevS=false, prevA=false;
     bool seeking_slider = false;
+    // Audio-only: video demuxer'da atılır (decode/dönüşüm/yükleme yok). --audio-only
+    // ya da A ile; pencere simge durumundayken otomatik. Sadece ses varken.
+    bool audio_only = opts.audio_only, video_suspended = false;
+    bool have_picture = false; // texture'da gösterilebilir bir kare var
     float volume01 = 1.0f;
 
     // Auto-hide control bar (overlay)
@@ -121,56 +164,106 @@ int run_player(const char* filename) {
     Uint32 last_interact = SDL_GetTicks();  // son etkileşim zamanı (ms)
     double prev_mx = -1.0, prev_my = -1.0;  // mouse hareketi için
     auto mark_interaction = [&](){ last_interact = SDL_GetTicks(); };
+    PerfOverlay perf;
+    if (opts.show_stats) perf_overlay_toggle(&perf);
 
-    auto prebuffer_audio = [&]() {
-        audio_started = false; audio_end_pts = 0.0; audio_pts_base = 0.0;
-        while (SDL_GetQueuedAudioSize(dev) < (Uint32)(0.3 * BYTES_PER_SEC)) {
-            uint8_t* data = nullptr; int nbytes = 0; double a_start = 0.0, a_end = 0.0;
-            if (!sound_reader_read(&sr, &data, &nbytes, &a_start, &a_end)) break;
-            if (!audio_started) {
-                audio_pts_base = a_start; audio_started = true;
-                if (!have_file_start) { file_start_sec = a_start; have_file_start = true; }
-            }
-            audio_end_pts = a_end;
-            apply_volume_s16(data, nbytes, volume01);
-            SDL_QueueAudio(dev, data, nbytes);
-            delete[] data;
-        }
+    // --- Prebuffer ~300ms ---
+    if (have_audio) audio_output_prebuffer(&ao);
+
+    // --- Video decode thread (decode producer thread'de, dönüşüm burada) ---
+    VideoDecoderState vd{};
+    video_decoder_start(&vd, &vr, 8);
+    const double vtb = (double)vr.time_base.num / (double)vr.time_base.den;
+    const double FIRST_FRAME_TIMEOUT_SEC = 5.0; // seek/başlangıç: decoder bu kadar sürede kare vermezse devam
+    // Sessiz klipte saat ilk karenin pts'inden başlar (seek sonrası da)
+    auto start_clock_at_first_frame = [&](double fallback_sec) {
+        const VideoFrameSlot* first = video_decoder_wait_frame(&vd, FIRST_FRAME_TIMEOUT_SEC);
+        master_clock_set(&clock, first ? first->pts * vtb : fallback_sec);
     };
-    prebuffer_audio();
-    SDL_PauseAudioDevice(dev, 0);
-
-    // --- Senkron ---
-    bool first_video = true; double video_pts_base = 0.0;
+    if (!have_audio) start_clock_at_first_frame(0.0);
+    const double file_start_sec = master_clock_get(&clock); // fixed file start
+    // PBO yoksa CPU dönüşümünün hedefi (64-byte hizalı satırlar); boyut değişince yeniden kurulur
+    FramePool* rgba_pool = nullptr;
+    size_t     rgba_size = 0;
+    master_clock_pause(&clock, false);
+
+    // --- Senkron (mutlak zaman: video pts <-> master clock) ---
+    const bool accurate_seek = opts.video_decode.accurate_seek;
+    const double SPIN_TAIL_SEC = 0.001; // son ~1ms: uyku hassasiyeti yetmez, yield ile bekle
+    FrameScheduler sched;
+    {
+        AVRational fr = dmx.fmt->streams[vr.video_stream_index]->avg_frame_rate;
+        frame_scheduler_init(&sched, (fr.num > 0 && fr.den > 0) ? (double)fr.den / fr.num : 0.0);
+    }
 
-    auto get_audio_clock_abs = [&]() -> double {
-        double queued = (double)SDL_GetQueuedAudioSize(dev) / (double)BYTES_PER_SEC;
-        return audio_end_pts - queued; // absolute sec
-    };
-    auto get_pos_rel = [&]() -> double { return get_audio_clock_abs() - file_start_sec; };
+    auto get_clock_abs = [&]() -> double { return master_clock_get(&clock); };
+    auto get_pos_rel = [&]() -> double { return get_clock_abs() - file_start_sec; };
     auto do_seek_rel = [&](double rel_sec) {
         if (rel_sec < 0.0) rel_sec = 0.0;
         double duration_sec = video_reader_get_duration_sec(&vr);
         if (duration_sec > 0.0 && rel_sec > duration_sec) rel_sec = duration_sec;
 
         double target_abs_sec = file_start_sec + rel_sec; // absolute
-        SDL_PauseAudioDevice(dev, 1);
-        SDL_ClearQueuedAudio(dev);
-        if (!sound_reader_seek(&sr, target_abs_sec)) std::printf("audio seek failed\n");
-        if (!video_reader_seek(&vr,  target_abs_sec)) std::printf("video seek failed\n");
-        prebuffer_audio();
-        first_video = true;
-        SDL_PauseAudioDevice(dev, paused ? 1 : 0);
+        master_clock_pause(&clock, true);
+        if (!demuxer_seek(&dmx, target_abs_sec)) std::printf("seek failed\n");
+        if (have_audio) audio_output_flush(&ao, target_abs_sec, accurate_seek);
+        video_decoder_flush(&vd);
+        if (have_audio) audio_output_prebuffer(&ao);
+        // hedef kare decode edilene kadar saati başlatma (accurate seek ileri decode eder)
+        if (have_audio) {
+            if (!video_suspended) video_decoder_wait_frame(&vd, FIRST_FRAME_TIMEOUT_SEC);
+        } else {
+            start_clock_at_first_frame(target_abs_sec);
+        }
+        frame_scheduler_reset(&sched);
+        perf_overlay_break(&perf);
+        master_clock_pause(&clock, paused);
         mark_interaction();
     };
 
+    // Karenin sunum zamanına kadar uyur (CPU harcamadan). Girdi olayı gelirse
+    // erken döner (false): döngü UI'ı hemen işler, kare sırada kalır.
+    auto wait_until_due = [&](double pts) -> bool {
+        while (true) {
+            double remaining = pts - get_clock_abs();
+            if (remaining <= 0.0) return true;
+            if (remaining > SPIN_TAIL_SEC) {
+                const double timeout = remaining - SPIN_TAIL_SEC;
+                const double t0 = stage_clock_now();
+                glfwWaitEventsTimeout(timeout);
+                if (stage_clock_now() - t0 < timeout * 0.9) return false; // olayla uyandı
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    };
+
     double duration_sec = video_reader_get_duration_sec(&vr);
 
     // FPS ölçümü (opsiyonel)
     uint32_t fps_t0 = SDL_GetTicks(); int frames_drawn = 0;
+    // Texture yükleme süresi (render thread'de geçen; dönüşüm hariç)
+    double upload_sec = 0.0, upload_sec_total = 0.0;
+    int    uploads = 0;
+    int64_t uploads_total = 0;
+
+    // Render-on-demand: yeni kare, girdi, pencere boyutu ya da bar görünürlüğü
+    // değişmediyse çizilmez; döngü olay gelene kadar uyur.
+    const int    UI_SETTLE_FRAMES = 3;     // olaydan sonra ImGui hover/aktif durumları oturana kadar
+    const double IDLE_WAIT_PAUSED = 0.5;   // duraklatılmışken en uzun uyku
+    const double IDLE_WAIT_PLAYING = 0.005; // oynarken kare yoksa (decoder geride) kısa bekle
+    const double IDLE_WAIT_AUDIO_ONLY = 0.25; // video askıdayken
+    const Uint32 AUDIO_ONLY_REDRAW_MS = 250;
+    Uint32 last_draw_ms = 0;
+    int  seen_events = -1, redraw_frames = UI_SETTLE_FRAMES;
+    int  last_ww = 0, last_wh = 0;
+    bool last_show_ui = false;
+    double idle_wait = 0.0; // >0: önceki turda çizilecek bir şey yoktu
 
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        if (idle_wait > 0.0) glfwWaitEventsTimeout(idle_wait);
+        else                 glfwPollEvents();
+        idle_wait = 0.0;
 
         // mouse hareketi -> UI görünür tut
         double mx, my; glfwGetCursorPos(window, &mx, &my);
@@ -179,7 +272,7 @@ int run_player(const char* filename) {
 
         // klavye
         bool sp = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
-        if (sp && !prevSpace) { paused = !paused; SDL_PauseAudioDevice(dev, paused ? 1 : 0); mark_interaction(); }
+        if (sp && !prevSpace) { paused = !paused; master_clock_pause(&clock, paused); mark_interaction(); }
         prevSpace = sp;
         bool left = glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS;
         if (left && !prevLeft) { do_seek_rel(get_pos_rel() - 5.0); }
@@ -187,42 +280,78 @@ int run_player(const char* filename) {
         bool right = glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS;
         if (right && !prevRight) { do_seek_rel(get_pos_rel() + 5.0); }
         prevRight = right;
+        // T: kaydı başlat; kayıt sürerken son olayları dosyaya yaz
+        bool t_key = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+        if (t_key && !prevT) {
+            if (!stage_trace_enabled()) { stage_trace_enable(true); std::printf("trace: recording\n"); }
+            else stage_trace_write_json(trace_path);
+        }
+        prevT = t_key;
+        bool s_key = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+        if (s_key && !prevS) perf_overlay_toggle(&perf);
+        prevS = s_key;
+        bool a_key = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+        if (a_key && !prevA) audio_only = !audio_only;
+        prevA = a_key;
+
+        // Audio-only'ye geçiş/dönüş: demuxer senkron askıya alır, sıradaki kareler atılır.
+        // Dönüşte video sonraki keyframe'den (zamanı gelince) devam eder.
+        const bool iconified = glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0;
+        const bool suspend = have_audio && (audio_only || iconified);
+        if (suspend != video_suspended && demuxer_set_video_suspended(&dmx, suspend)) {
+            video_decoder_flush(&vd);
+            frame_scheduler_reset(&sched);
+            perf_overlay_break(&perf);
+            video_suspended = suspend;
+            if (suspend) have_picture = false;
+        }
 
-        // Ses kuyruğu
+        // Video frame (decode thread'den, bloklamadan). Geç kalmış kareler,
+        // sıradaki de zamanı geldiyse dönüştürülmeden atılır.
+        const VideoFrameSlot* vframe = nullptr; double vpts_sec = 0.0;
         if (!paused && !seeking_slider) {
-            while (SDL_GetQueuedAudioSize(dev) < (Uint32)(0.3 * BYTES_PER_SEC)) {
-                uint8_t* data = nullptr; int nbytes = 0; double a_start = 0.0, a_end = 0.0;
-                if (!sound_reader_read(&sr, &data, &nbytes, &a_start, &a_end)) break;
-                audio_end_pts = a_end;
-                apply_volume_s16(data, nbytes, volume01);
-                SDL_QueueAudio(dev, data, nbytes);
-                delete[] data;
+            while ((vframe = video_decoder_peek(&vd))) {
+                vpts_sec = vframe->pts * vtb;
+                const VideoFrameSlot* next = video_decoder_peek_next(&vd);
+                double next_pts = next ? next->pts * vtb : 0.0;
+                // Video master'da kare atılmaz: saat sunulan kareye oturur, oynatma yavaşlar
+                if (clock.type == MASTER_CLOCK_VIDEO ||
+                    frame_scheduler_decide(vpts_sec, next ? &next_pts : nullptr,
+                                           get_clock_abs()) != FRAME_DROP)
+                    break;
+                video_decoder_pop(&vd);
+                frame_scheduler_dropped(&sched);
             }
+            if (!vframe && video_decoder_eof(&vd)) break; // EOF
+            if (!vframe) frame_scheduler_idle(&sched, get_clock_abs());
         }
 
-        // Video frame
-        int64_t vpts_i64 = 0; double vpts_sec = 0.0;
-        if (!paused && !seeking_slider) {
-            if (!video_reader_read_frame(&vr, frame_data, &vpts_i64)) break; // EOF
-            vpts_sec = vpts_i64 * (double)vr.time_base.num / (double)vr.time_base.den;
-            if (first_video) { video_pts_base = vpts_sec; first_video = false; }
-        }
+        // Senkron (audio master): deadline'a kadar uyu
+        if (vframe && !wait_until_due(vpts_sec)) vframe = nullptr;
+        if (vframe) master_clock_presented(&clock, vpts_sec); // video master: saat kareye oturur
 
-        // Senkron (audio master)
-        if (!paused && !seeking_slider) {
-            double queued_sec = (double)SDL_GetQueuedAudioSize(dev) / (double)BYTES_PER_SEC;
-            double audio_clock_rel = (audio_end_pts - audio_pts_base) - queued_sec;
-            double video_rel = vpts_sec - video_pts_base;
-            while (video_rel > audio_clock_rel) {
-                glfwPollEvents();
-                SDL_Delay(1);
-                queued_sec = (double)SDL_GetQueuedAudioSize(dev) / (double)BYTES_PER_SEC;
-                audio_clock_rel = (audio_end_pts - audio_pts_base) - queued_sec;
-            }
+        // Auto-hide görünürlük mantığı
+        int ww, wh; glfwGetFramebufferSize(window, &ww, &wh);
+        Uint32 now_ms = SDL_GetTicks();
+        bool hover_bottom = (my >= (double)(wh - 80)); // pencerenin altına yakın
+        bool show_ui = paused || hover_bottom || seeking_slider || (now_ms - last_interact < 1800);
+        // Audio-only'de yeni kare gelmez: görünür pencerede süre göstergesi için ara ara çiz
+        if (video_suspended && !iconified && show_ui && now_ms - last_draw_ms >= AUDIO_ONLY_REDRAW_MS)
+            redraw_frames = std::max(redraw_frames, 1);
+
+        // Çizilecek bir şey yoksa (texture'daki kare aynı, UI durgun) sonraki olaya kadar uyu
+        if (seen_events != g_window_events) { seen_events = g_window_events; redraw_frames = UI_SETTLE_FRAMES; }
+        if (ww != last_ww || wh != last_wh || show_ui != last_show_ui || seeking_slider)
+            redraw_frames = std::max(redraw_frames, 1);
+        if (!vframe && redraw_frames == 0) {
+            // (oynarken kısa uyku bar'ın gizlenme anını da yakalar)
+            idle_wait = paused ? IDLE_WAIT_PAUSED : video_suspended ? IDLE_WAIT_AUDIO_ONLY : IDLE_WAIT_PLAYING;
+            continue;
         }
+        if (redraw_frames > 0) redraw_frames--;
+        last_ww = ww; last_wh = wh; last_show_ui = show_ui; last_draw_ms = now_ms;
 
         // Render video (tüm pencere; overlay bar video'nun üstüne biner ve idle'da kaybolur)
-        int ww, wh; glfwGetFramebufferSize(window, &ww, &wh);
         glViewport(0, 0, ww, wh);
         glClearColor(0.f, 0.f, 0.f, 1.f);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -230,10 +359,6 @@ int run_player(const char* filename) {
         glMatrixMode(GL_PROJECTION); glLoadIdentity(); glOrtho(0, ww, 0, wh, -1, 1);
         glMatrixMode(GL_MODELVIEW);  glLoadIdentity();
 
-        glBindTexture(GL_TEXTURE_2D, tex_handle);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, frame_width, frame_height,
-                        GL_RGBA, GL_UNSIGNED_BYTE, frame_data);
-
         double sx = (double)ww / (double)frame_width;
         double sy = (double)wh / (double)frame_height;
         double scale = (sx < sy) ? sx : sy;
@@ -242,26 +367,84 @@ int run_player(const char* filename) {
         int x0 = (ww - draw_w) / 2; int y0 = (wh - draw_h) / 2;
         int x1 = x0 + draw_w;       int y1 = y0 + draw_h;
 
-        glColor4f(1.f, 1.f, 1.f, 1.f);
-        glEnable(GL_TEXTURE_2D);
-        glBegin(GL_QUADS);
-            glTexCoord2d(0, 1); glVertex2i(x0, y0);
-            glTexCoord2d(1, 1); glVertex2i(x1, y0);
-            glTexCoord2d(1, 0); glVertex2i(x1, y1);
-            glTexCoord2d(0, 0); glVertex2i(x0, y1);
-        glEnd();
-        glDisable(GL_TEXTURE_2D);
+        if (vframe) {
+            // yeni kare yoksa texture'daki son kare tekrar çizilir
+            const double up_t0 = stage_clock_now(), scale0 = vr.stat_scale_sec;
+            if (use_gl_yuv && gl_yuv_upload(&yuv_gl, vframe->frame, use_pbo ? &pbo : nullptr)) {
+                yuv_shown = true;
+            } else {
+                glBindTexture(GL_TEXTURE_2D, tex_handle);
+                // Dönüşüm boyutu sadece yeni kareyle değişir: texture hemen dolar
+                // (duraklatılmışken son kare eski boyutta kalır, GPU ölçekler)
+                if (video_reader_set_output_size(&vr, draw_w, draw_h)) {
+                    tex_w = vr.out_width; tex_h = vr.out_height;
+                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tex_w, tex_h, 0,
+                                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                }
+                // PBO: dönüşüm doğrudan map edilmiş belleğe, yükleme offset 0'dan.
+                // Yoksa havuzdan bir buffer'a (her karede ayırma yok).
+                uint8_t* dst = use_pbo ? gl_pbo_map(&pbo, (size_t)tex_w * tex_h * 4) : nullptr;
+                const bool in_pbo = dst != nullptr;
+                const int stride = in_pbo ? tex_w * 4 : frame_pool_stride(tex_w * 4);
+                AVBufferRef* rgba = nullptr;
+                if (!in_pbo) {
+                    const size_t size = (size_t)stride * tex_h;
+                    if (size != rgba_size) {
+                        frame_pool_release(&rgba_pool);
+                        rgba_pool = frame_pool_create(size, 2);
+                        rgba_size = size;
+                    }
+                    rgba = frame_pool_get(rgba_pool);
+                    dst = rgba ? rgba->data : nullptr;
+                }
+                bool ok = dst && video_reader_convert(&vr, vframe->frame, dst, stride);
+                if (in_pbo) ok = gl_pbo_unmap(&pbo) && ok;
+                if (ok) {
+                    glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / 4);
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tex_w, tex_h,
+                                    GL_RGBA, GL_UNSIGNED_BYTE, in_pbo ? nullptr : dst);
+                    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                }
+                if (in_pbo) gl_pbo_unbind(&pbo);
+                av_buffer_unref(&rgba); // yükleme senkron: buffer havuza döner
+                yuv_shown = false;
+            }
+            const double up_t1 = stage_clock_now();
+            const double convert_sec = vr.stat_scale_sec - scale0;
+            upload_sec += up_t1 - up_t0 - convert_sec;
+            if (stage_trace_enabled()) stage_trace_record("texture upload", up_t0, up_t1);
+            uploads++;
+            have_picture = true;
+            const double clock_now = get_clock_abs();
+            frame_scheduler_presented(&sched, vpts_sec, clock_now);
+            if (perf.visible)
+                perf_overlay_presented(&perf, up_t1, vframe->decode_sec, convert_sec,
+                                       up_t1 - up_t0 - convert_sec, clock_now - vpts_sec);
+            video_decoder_pop(&vd);
+        }
+
+        if (!have_picture) {
+            // audio-only ya da henüz kare yok: sadece arka plan
+        } else if (yuv_shown) {
+            gl_yuv_draw(&yuv_gl, x0, y0, x1, y1);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, tex_handle);
+            glColor4f(1.f, 1.f, 1.f, 1.f);
+            glEnable(GL_TEXTURE_2D);
+            glBegin(GL_QUADS);
+                glTexCoord2d(0, 1); glVertex2i(x0, y0);
+                glTexCoord2d(1, 1); glVertex2i(x1, y0);
+                glTexCoord2d(1, 0); glVertex2i(x1, y1);
+                glTexCoord2d(0, 0); glVertex2i(x0, y1);
+            glEnd();
+            glDisable(GL_TEXTURE_2D);
+        }
 
         // --- ImGui ---
         ImGui_ImplOpenGL2_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        // Auto-hide görünürlük mantığı
-        Uint32 now_ms = SDL_GetTicks();
-        bool hover_bottom = (my >= (double)(wh - 80)); // pencerenin altına yakın
-        bool show_ui = paused || hover_bottom || seeking_slider || (now_ms - last_interact < 1800);
-
         if (show_ui) {
             ImGui::SetNextWindowBgAlpha(paused ? 1.0f : 0.92f);
             ImGui::SetNextWindowPos(ImVec2(0, (float)(wh - bar_h)), ImGuiCond_Always);
@@ -275,7 +458,7 @@ int run_player(const char* filename) {
                 // Üst satır
                 ImGui::Columns(3, nullptr, false);
                 if (ImGui::Button(paused ? "Play (Space)" : "Pause (Space)", ImVec2(150, 32))) {
-                    paused = !paused; SDL_PauseAudioDevice(dev, paused ? 1 : 0); mark_interaction();
+                    paused = !paused; master_clock_pause(&clock, paused); mark_interaction();
                 }
                 ImGui::NextColumn();
 
@@ -285,13 +468,17 @@ int run_player(const char* filename) {
                 ImGui::Text("  %s / %s", time_left.c_str(), time_total.c_str());
                 ImGui::NextColumn();
 
-                ImGui::Text("Volume");
-                ImGui::SameLine();
-                if (ImGui::SliderFloat("##vol", &volume01, 0.0f, 1.0f, "%.2f")) {
-                    mark_interaction();
-                    // Anında etki istiyorsan aşağıyı aç:
-                    // SDL_PauseAudioDevice(dev, 1); SDL_ClearQueuedAudio(dev); prebuffer_audio(); SDL_PauseAudioDevice(dev, paused?1:0);
+                if (have_audio) {
+                    ImGui::Text("Volume");
+                    ImGui::SameLine();
+                    if (ImGui::SliderFloat("##vol", &volume01, 0.0f, 1.0f, "%.2f")) {
+                        ao.volume = volume01; // callback'te uygulanır, anında etki eder
+                        mark_interaction();
+                    }
+                } else {
+                    ImGui::Text("No audio (%s clock)", master_clock_name(clock.type));
                 }
+                if (video_suspended) { ImGui::SameLine(); ImGui::Text("  Audio only (A)"); }
                 ImGui::Columns(1);
 
                 // Timeline
@@ -316,31 +503,97 @@ int run_player(const char* filename) {
             ImGui::End();
         }
 
-        ImGui::Render();
-        ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+        if (perf.visible) {
+            PerfSnapshot snap;
+            if (have_audio)
+                snap.audio_queued_ms = audio_output_buffered_bytes(&ao) * 1e3 /
+                                       ((double)ao.bytes_per_frame * ao.sample_rate);
+            snap.decode_codec     = vr.av_codec_ctx->codec->name;
+            snap.decode_threads   = vr.av_codec_ctx->thread_count;
+            snap.decode_threading = video_reader_threading(&vr);
+            snap.video_ready    = video_decoder_ready(&vd);
+            snap.video_capacity = vd.capacity;
+            snap.video_packets  = packet_queue_size(&dmx.video_q);
+            snap.audio_packets  = packet_queue_size(&dmx.audio_q);
+            if (!yuv_shown) {
+                snap.convert_w = vr.out_width; snap.convert_h = vr.out_height;
+                snap.convert_kernel = vr.convert_kernel;
+            }
+            snap.presented  = sched.stats.presented;
+            snap.dropped    = sched.stats.dropped;
+            snap.late       = sched.stats.late;
+            snap.duplicated = sched.stats.duplicated;
+            perf_overlay_draw(&perf, snap);
+        }
 
-        glfwSwapBuffers(window);
+        {
+            STAGE_SCOPE("imgui render");
+            ImGui::Render();
+            ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+        }
+        {
+            STAGE_SCOPE("swap buffers");
+            glfwSwapBuffers(window);
+        }
+        if (perf.visible) {
+            if (paused) perf_overlay_break(&perf); // duraklatma aralığı kare süresi değil
+            else        perf_overlay_frame(&perf, stage_clock_now());
+        }
 
         // FPS title
         frames_drawn++;
         uint32_t now = SDL_GetTicks();
         if (now - fps_t0 >= 1000) {
             double fps = (double)frames_drawn * 1000.0 / (double)(now - fps_t0);
-            char title[160];
+            const FrameSchedulerStats& fs = sched.stats;
+            char title[256];
             std::snprintf(title, sizeof(title),
-                          "Video Player  |  %.1f FPS   [Space: Play/Pause, <-/->: +/-5s]",
-                          fps);
+                          "Video Player  |  %.1f FPS  drop %lld  late %lld  dup %lld  drift %+.0f ms"
+                          "  upload %.2f ms   [Space: Play/Pause, <-/->: +/-5s, S: stats, A: audio only]",
+                          fps, (long long)fs.dropped, (long long)fs.late, (long long)fs.duplicated,
+                          fs.drift * 1e3, uploads > 0 ? upload_sec * 1e3 / uploads : 0.0);
             glfwSetWindowTitle(window, title);
             frames_drawn = 0; fps_t0 = now;
+            upload_sec_total += upload_sec; uploads_total += uploads;
+            upload_sec = 0.0; uploads = 0;
+        }
+    }
+
+    if (stage_trace_enabled()) stage_trace_write_json(trace_path);
+
+    std::printf("video: %lld presented, %lld dropped, %lld late, %lld duplicated, "
+                "drift avg %+.1f ms max %+.1f ms\n",
+                (long long)sched.stats.presented, (long long)sched.stats.dropped,
+                (long long)sched.stats.late, (long long)sched.stats.duplicated,
+                sched.stats.drift * 1e3, sched.stats.max_drift * 1e3);
+    upload_sec_total += upload_sec; uploads_total += uploads;
+    std::printf("upload: %lld frame(s), %.3f ms/frame (%s)\n", (long long)uploads_total,
+                uploads_total > 0 ? upload_sec_total * 1e3 / uploads_total : 0.0, use_pbo ? "PBO" : "direct");
+    {
+        FramePoolStats ps = decoder_frame_pool_stats(&vr.frame_pool);
+        std::printf("frame pool: decoder %d/%d buffers (peak in use %d), %lld allocations, "
+                    "%lld reuses, %lld fallbacks\n", ps.allocated, ps.capacity, ps.peak_in_use,
+                    (long long)ps.allocations, (long long)ps.reuses, (long long)ps.fallbacks);
+        if (rgba_pool) {
+            ps = frame_pool_stats(rgba_pool);
+            std::printf("frame pool: rgba %d/%d buffers, %lld allocations, %lld reuses\n",
+                        ps.allocated, ps.capacity, (long long)ps.allocations, (long long)ps.reuses);
         }
     }
 
     // --- cleanup ---
-    delete[] frame_data;
+    demuxer_stop(&dmx); // bekleyen decoder'ları uyandırır
+    video_decoder_stop(&vd);
+    gl_yuv_destroy(&yuv_gl);
+    gl_pbo_destroy(&pbo);
+    frame_pool_release(&rgba_pool);
     glDeleteTextures(1, &tex_handle);
     video_reader_close(&vr);
-    SDL_CloseAudioDevice(dev);
-    sound_reader_close(&sr);
+    if (have_audio) {
+        audio_output_close(&ao);
+        sound_reader_close(&sr);
+    }
+    demuxer_close(&dmx);
     ImGui_ImplOpenGL2_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -1,7 +1,21 @@
 #ifndef VIDEO_APP_PLAYER_HPP
 #define VIDEO_APP_PLAYER_HPP
 
+#include "master_clock.hpp"
+#include "video_reader.hpp"
+
+// Komut satırından gelen ayarlar
+struct PlayerOptions {
+    VideoDecodeOptions video_decode;
+    bool               gpu_yuv = true; // YUV düzlemlerini yükle, RGB'ye shader'da çevir (GL 2.0)
+    bool               pbo_upload = true; // texture yüklemesi PBO halkası üzerinden (GL 2.1)
+    MasterClockType    sync = MASTER_CLOCK_AUDIO; // ses yoksa EXTERNAL'a düşer; VIDEO/EXTERNAL sesi açmaz
+    bool               audio_only = false; // video decode edilmez (pencere simge durumundayken de)
+    bool               show_stats = false; // istatistik paneli açık başlar (S ile değişir)
+    const char*        trace_path = nullptr; // verilirse baştan kaydedilir, çıkışta yazılır
+};
+
 // Basit API: ver yolu, oynat (GLFW+SDL2 penceresi açar).
-int run_player(const char* filename);
+int run_player(const char* filename, const PlayerOptions& opts = PlayerOptions());
 
 #endif
@@ -3,8 +3,8 @@ extern "C" {
 #include <libavutil/channel_layout.h>
 }
 #include "sound_reader.hpp"
+#include "stage_trace.hpp"
 #include <cstdio>
-#include <cstring>
 #include <cmath>
 
 static inline const char* err2str(int e) {
@@ -13,7 +13,33 @@ static inline const char* err2str(int e) {
     return buf;
 }
 
-bool sound_reader_open(SoundReaderState* st, const char* filename,
+// Seek sonrası decoder ve resampler'ı sıfırla
+static bool sound_reader_reset(SoundReaderState* st) {
+    avcodec_flush_buffers(st->dec);
+    if (st->frame) av_frame_unref(st->frame);
+    st->frame_pending = false;
+
+    // --- ÖNEMLİ: Resampler'ı resetle (swr_reset yoksa yeniden oluştur) ---
+    if (st->swr) swr_free(&st->swr);
+    st->swr = swr_alloc_set_opts(
+        nullptr,
+        st->dst_ch_layout, st->dst_fmt, st->dst_sample_rate,
+        st->src_ch_layout, st->dec->sample_fmt, st->src_sample_rate,
+        0, nullptr
+    );
+    if (!st->swr) {
+        std::printf("audio: swr_alloc_set_opts (recreate) failed\n");
+        return false;
+    }
+    int ret = swr_init(st->swr);
+    if (ret < 0) {
+        std::printf("audio: swr_init (recreate) failed: %s\n", err2str(ret));
+        return false;
+    }
+    return true;
+}
+
+bool sound_reader_open(SoundReaderState* st, DemuxerState* demuxer,
                        int dst_sample_rate, int dst_channels,
                        AVSampleFormat dst_fmt) {
     st->dst_sample_rate = dst_sample_rate;
@@ -23,22 +49,13 @@ bool sound_reader_open(SoundReaderState* st, const char* filename,
 
     int ret = 0;
 
-    ret = avformat_open_input(&st->fmt, filename, nullptr, nullptr);
-    if (ret < 0) { std::printf("audio: open_input failed: %s\n", err2str(ret)); return false; }
-
-    ret = avformat_find_stream_info(st->fmt, nullptr);
-    if (ret < 0) { std::printf("audio: find_stream_info failed: %s\n", err2str(ret)); return false; }
-
-    // Find first audio stream
+    // Audio stream demuxer tarafından seçildi
     const AVCodec* dec = nullptr;
     AVCodecParameters* params = nullptr;
-    for (unsigned i = 0; i < st->fmt->nb_streams; ++i) {
-        if (st->fmt->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-            st->stream_index = (int)i;
-            params = st->fmt->streams[i]->codecpar;
-            dec = avcodec_find_decoder(params->codec_id);
-            if (dec) break;
-        }
+    st->stream_index = demuxer->audio_stream_index;
+    if (st->stream_index >= 0) {
+        params = demuxer->fmt->streams[st->stream_index]->codecpar;
+        dec = avcodec_find_decoder(params->codec_id);
     }
     if (st->stream_index < 0 || !dec) {
         std::printf("audio: no audio stream/decoder\n");
@@ -77,123 +94,114 @@ bool sound_reader_open(SoundReaderState* st, const char* filename,
     ret = swr_init(st->swr);
     if (ret < 0) { std::printf("audio: swr_init failed: %s\n", err2str(ret)); return false; }
 
-    st->time_base = st->fmt->streams[st->stream_index]->time_base;
+    st->bytes_per_frame = st->dst_channels * av_get_bytes_per_sample(st->dst_fmt);
+    st->time_base = demuxer->fmt->streams[st->stream_index]->time_base;
+    st->serial    = packet_queue_serial(&demuxer->audio_q);
+    st->pkt_queue = &demuxer->audio_q;
+    st->pkt_queue->enabled = true;
     return true;
 }
 
-bool sound_reader_read(SoundReaderState* st,
-                       uint8_t** out_data, int* out_nbytes,
-                       double* pts_start_sec, double* pts_end_sec) {
-    *out_data = nullptr; *out_nbytes = 0;
-    *pts_start_sec = 0.0; *pts_end_sec = 0.0;
+int sound_reader_decode(SoundReaderState* st, double* pts_start_sec, double* pts_end_sec) {
+    *pts_start_sec = 0.0;
+    if (st->frame_pending) { av_frame_unref(st->frame); st->frame_pending = false; }
 
     int ret = 0;
-
-    while ((ret = av_read_frame(st->fmt, st->pkt)) >= 0) {
-        if (st->pkt->stream_index != st->stream_index) {
-            av_packet_unref(st->pkt);
-            continue;
-        }
-
-        ret = avcodec_send_packet(st->dec, st->pkt);
-        av_packet_unref(st->pkt);
-        if (ret < 0) { std::printf("audio: send_packet: %s\n", err2str(ret)); return false; }
-
+    while (true) {
+        // Bir paket birden çok frame verebilir: önce decoder'dakileri al
+        double t0 = stage_clock_now();
         ret = avcodec_receive_frame(st->dec, st->frame);
-        if (ret == AVERROR(EAGAIN)) {
-            continue;
-        } else if (ret == AVERROR_EOF) {
-            return false; // bitti
-        } else if (ret < 0) {
+        stage_trace_add(&st->stat_decode_sec, "audio decode", t0);
+        if (ret >= 0) break;
+        if (ret == AVERROR_EOF) return -1; // bitti
+        if (ret != AVERROR(EAGAIN)) {
             std::printf("audio: receive_frame: %s\n", err2str(ret));
-            return false;
+            return -1;
         }
 
-        int64_t ts = (st->frame->best_effort_timestamp == AV_NOPTS_VALUE)
-                       ? st->frame->pts : st->frame->best_effort_timestamp;
-        *pts_start_sec = ts * (double)st->time_base.num / (double)st->time_base.den;
-
-        int64_t delay = swr_get_delay(st->swr, st->src_sample_rate);
-        int out_count = (int)av_rescale_rnd(delay + st->frame->nb_samples,
-                                            st->dst_sample_rate, st->src_sample_rate, AV_ROUND_UP);
-
-        int out_linesize = 0;
-        uint8_t* out_buf = nullptr;
-        int ret_alloc = av_samples_alloc(&out_buf, &out_linesize,
-                                         st->dst_channels, out_count, st->dst_fmt, 0);
-        if (ret_alloc < 0) {
-            std::printf("audio: av_samples_alloc failed: %s\n", err2str(ret_alloc));
-            return false;
+        int serial = 0;
+        int got = packet_queue_get(st->pkt_queue, st->pkt, &serial, true);
+        if (serial != st->serial) {
+            if (!sound_reader_reset(st)) return -1;
+            st->serial = serial;
         }
+        if (got < 0) return -1; // EOF
 
-        uint8_t** in_data = st->frame->extended_data;
-        int out_samples = swr_convert(st->swr, &out_buf, out_count,
-                                      (const uint8_t**)in_data, st->frame->nb_samples);
-        if (out_samples < 0) {
-            std::printf("audio: swr_convert failed\n");
-            av_freep(&out_buf);
-            return false;
-        }
-
-        int bytes_per_sample = av_get_bytes_per_sample(st->dst_fmt);
-        int total_bytes = out_samples * st->dst_channels * bytes_per_sample;
+        t0 = stage_clock_now();
+        ret = avcodec_send_packet(st->dec, st->pkt);
+        stage_trace_add(&st->stat_decode_sec, "audio decode", t0);
+        av_packet_unref(st->pkt);
+        if (ret < 0) { std::printf("audio: send_packet: %s\n", err2str(ret)); return -1; }
+    }
+    st->frame_pending = true;
 
-        uint8_t* interleaved = new uint8_t[total_bytes];
-        std::memcpy(interleaved, out_buf, total_bytes);
-        av_freep(&out_buf);
+    int64_t ts = (st->frame->best_effort_timestamp == AV_NOPTS_VALUE)
+                   ? st->frame->pts : st->frame->best_effort_timestamp;
+    *pts_start_sec = ts * (double)st->time_base.num / (double)st->time_base.den;
+    if (pts_end_sec) *pts_end_sec = *pts_start_sec + st->frame->nb_samples / (double)st->src_sample_rate;
 
-        *out_data   = interleaved;
-        *out_nbytes = total_bytes;
-        *pts_end_sec = *pts_start_sec + (double)out_samples / (double)st->dst_sample_rate;
+    int64_t delay = swr_get_delay(st->swr, st->src_sample_rate);
+    int out_count = (int)av_rescale_rnd(delay + st->frame->nb_samples,
+                                        st->dst_sample_rate, st->src_sample_rate, AV_ROUND_UP);
+    return out_count * st->bytes_per_frame;
+}
 
-        av_frame_unref(st->frame);
-        return true;
+int sound_reader_convert(SoundReaderState* st,
+                         uint8_t* out0, int cap0_bytes,
+                         uint8_t* out1, int cap1_bytes) {
+    if (!st->frame_pending) return 0;
+    st->frame_pending = false;
+
+    const uint8_t** in_data = (const uint8_t**)st->frame->extended_data;
+    double t0 = stage_clock_now();
+    int n0 = swr_convert(st->swr, &out0, cap0_bytes / st->bytes_per_frame,
+                         in_data, st->frame->nb_samples);
+    int n1 = 0;
+    if (n0 >= 0 && out1 && cap1_bytes > 0) {
+        // ilk parçaya sığmayan çıktı swr içinde tamponlandı; in_count=0 ile (NULL değil,
+        // NULL resampler'ı drain eder) ikinci parçaya al
+        n1 = swr_convert(st->swr, &out1, cap1_bytes / st->bytes_per_frame, in_data, 0);
+    }
+    stage_trace_add(&st->stat_resample_sec, "swr_convert", t0);
+    av_frame_unref(st->frame);
+    if (n0 < 0 || n1 < 0) {
+        std::printf("audio: swr_convert failed\n");
+        return -1;
     }
-    return false; // EOF
+    return (n0 + n1) * st->bytes_per_frame;
 }
 
-bool sound_reader_seek(SoundReaderState* st, double seconds) {
-    if (!st || !st->fmt) return false;
-
-    // hedef zaman damgası (stream time_base)
-    int64_t ts = (int64_t)llround(seconds * st->time_base.den / (double)st->time_base.num);
-    int ret = av_seek_frame(st->fmt, st->stream_index, ts, AVSEEK_FLAG_BACKWARD);
-    if (ret < 0) {
-        std::printf("audio: seek failed: %s\n", err2str(ret));
-        return false;
-    }
+bool sound_reader_read(SoundReaderState* st,
+                       const uint8_t** out_data, int* out_nbytes,
+                       double* pts_start_sec, double* pts_end_sec) {
+    *out_data = nullptr; *out_nbytes = 0;
+    *pts_end_sec = 0.0;
 
-    // decoder ve paket/frame durumunu sıfırla
-    avcodec_flush_buffers(st->dec);
-    if (st->pkt)   av_packet_unref(st->pkt);
-    if (st->frame) av_frame_unref(st->frame);
+    int max_bytes = sound_reader_decode(st, pts_start_sec);
+    if (max_bytes < 0) return false;
 
-    // --- ÖNEMLİ: Resampler'ı resetle (swr_reset yoksa yeniden oluştur) ---
-    if (st->swr) swr_free(&st->swr);
-    st->swr = swr_alloc_set_opts(
-        nullptr,
-        st->dst_ch_layout, st->dst_fmt, st->dst_sample_rate,
-        st->src_ch_layout, st->dec->sample_fmt, st->src_sample_rate,
-        0, nullptr
-    );
-    if (!st->swr) {
-        std::printf("audio: swr_alloc_set_opts (recreate) failed\n");
-        return false;
-    }
-    ret = swr_init(st->swr);
-    if (ret < 0) {
-        std::printf("audio: swr_init (recreate) failed: %s\n", err2str(ret));
-        return false;
+    if (max_bytes > st->out_buf_size) {
+        av_freep(&st->out_buf);
+        st->out_buf = (uint8_t*)av_malloc((size_t)max_bytes);
+        st->out_buf_size = st->out_buf ? max_bytes : 0;
+        if (!st->out_buf) { std::printf("audio: out buffer alloc failed\n"); return false; }
     }
 
+    int total_bytes = sound_reader_convert(st, st->out_buf, st->out_buf_size, nullptr, 0);
+    if (total_bytes < 0) return false;
+
+    *out_data    = st->out_buf;
+    *out_nbytes  = total_bytes;
+    *pts_end_sec = *pts_start_sec + (double)(total_bytes / st->bytes_per_frame) / (double)st->dst_sample_rate;
     return true;
 }
 
-
 void sound_reader_close(SoundReaderState* st) {
+    if (st->pkt_queue) st->pkt_queue->enabled = false; // demuxer artık ses paketlerini atar
     if (st->swr)   swr_free(&st->swr);
     if (st->dec)   avcodec_free_context(&st->dec);
-    if (st->fmt)   { avformat_close_input(&st->fmt); avformat_free_context(st->fmt); }
     if (st->frame) av_frame_free(&st->frame);
     if (st->pkt)   av_packet_free(&st->pkt);
+    av_freep(&st->out_buf);
+    st->out_buf_size = 0;
 }
@@ -8,6 +8,7 @@ extern "C" {
 #include <libavutil/avutil.h>
 }
 #include <cstdint>
+#include "demuxer.hpp"
 
 struct SoundReaderState {
     // Public
@@ -15,9 +16,13 @@ struct SoundReaderState {
     int dst_channels;
     AVSampleFormat dst_fmt;
     AVRational time_base;
+    int serial = 0; // son dönen verinin paket kuyruğu serial'ı
+
+    // Cumulative stage times (seconds, audio decode thread)
+    double stat_decode_sec = 0.0, stat_resample_sec = 0.0;
 
     // Private
-    AVFormatContext* fmt = nullptr;
+    PacketQueue*     pkt_queue = nullptr;
     AVCodecContext*  dec = nullptr;
     int              stream_index = -1;
     AVFrame*         frame = nullptr;
@@ -26,20 +31,36 @@ struct SoundReaderState {
     int64_t          dst_ch_layout = 0; // (deprecated API kullanımıyla uyumlu)
     int64_t          src_ch_layout = 0;
     int              src_sample_rate = 0;
+    int              bytes_per_frame = 0;       // dst_channels * sample size
+    bool             frame_pending   = false;   // decode edildi, henüz convert edilmedi
+    uint8_t*         out_buf = nullptr;         // sound_reader_read için, sadece büyür
+    int              out_buf_size = 0;
 };
 
-bool sound_reader_open(SoundReaderState* st, const char* filename,
+// Paketler demuxer'ın ses kuyruğundan okunur (seek: demuxer_seek).
+bool sound_reader_open(SoundReaderState* st, DemuxerState* demuxer,
                        int dst_sample_rate = 48000,
                        int dst_channels    = 2,
                        AVSampleFormat dst_fmt = AV_SAMPLE_FMT_S16);
 
+// Allocation-free iki adımlı API (dst_fmt packed/interleaved olmalı):
+// decode: sıradaki frame'i reader içinde bekletir, dönüştürülmüş boyutun üst
+// sınırını (byte) döner; EOF/hata: -1.
+int sound_reader_decode(SoundReaderState* st, double* pts_start_sec, double* pts_end_sec = nullptr);
+
+// Bekleyen frame'i doğrudan çağıranın belleğine dönüştürür. Hedef ring buffer
+// sarmasında olduğu gibi iki parça olabilir; boyutlar bytes_per_frame'in katı
+// olmalı. Yazılan byte sayısını döner (hata: -1).
+int sound_reader_convert(SoundReaderState* st,
+                         uint8_t* out0, int cap0_bytes,
+                         uint8_t* out1, int cap1_bytes);
+
+// decode + convert, reader'a ait (sadece büyüyen) buffer'a. *out_data bir
+// sonraki çağrıya kadar geçerlidir, çağıran free etmez.
 bool sound_reader_read(SoundReaderState* st,
-                       uint8_t** out_data, int* out_nbytes,
+                       const uint8_t** out_data, int* out_nbytes,
                        double* pts_start_sec, double* pts_end_sec);
 
 void sound_reader_close(SoundReaderState* st);
 
-// NEW: seek (seconds)
-bool sound_reader_seek(SoundReaderState* st, double seconds);
-
 #endif
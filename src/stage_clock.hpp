@@ -0,0 +1,11 @@
+#ifndef stage_clock_hpp
+#define stage_clock_hpp
+
+#include <chrono>
+
+// Monotonic seconds, for the cumulative per-stage timers in the readers.
+inline double stage_clock_now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include "stage_trace.hpp"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+static const uint32_t RING_SIZE = 1 << 14; // thread başına son ~16K olay
+
+struct TraceEvent {
+    const char* name;
+    double      t0, t1;
+};
+
+// Export yazarla yarışabilir: alanlar relaxed atomic (x86'da düz mov),
+// yırtık okunan olaylar head karşılaştırmasıyla atılır
+struct TraceSlot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<double>      t0{0.0}, t1{0.0};
+};
+
+struct TraceRing {
+    TraceSlot                events[RING_SIZE];
+    std::atomic<uint32_t>    head{0}; // toplam yazılan (sadece sahibi yazar)
+    std::atomic<const char*> thread_name{nullptr};
+    int                      tid = 0;
+};
+
+static std::atomic<bool> g_enabled{false};
+static std::mutex        g_rings_mtx; // sadece kayıt ve export
+static std::vector<std::unique_ptr<TraceRing>> g_rings;
+static double            g_epoch = 0.0;
+
+void stage_trace_enable(bool on) {
+    if (on && g_epoch == 0.0) g_epoch = stage_clock_now();
+    g_enabled.store(on, std::memory_order_relaxed);
+}
+
+bool stage_trace_enabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+static thread_local TraceRing*  t_ring = nullptr;
+static thread_local const char* t_name = nullptr; // ring yokken de tutulur
+
+// Ring ilk kayıtta ayrılır (iz kapalıyken thread başına bellek yok);
+// thread bitse de export için kalır
+static TraceRing* thread_ring() {
+    if (!t_ring) {
+        std::lock_guard<std::mutex> lock(g_rings_mtx);
+        g_rings.emplace_back(new TraceRing());
+        t_ring = g_rings.back().get();
+        t_ring->tid = (int)g_rings.size();
+        t_ring->thread_name.store(t_name, std::memory_order_relaxed);
+    }
+    return t_ring;
+}
+
+void stage_trace_thread_name(const char* name) {
+    t_name = name;
+    if (t_ring) t_ring->thread_name.store(name, std::memory_order_relaxed);
+}
+
+void stage_trace_record(const char* name, double t0, double t1) {
+    TraceRing* r = thread_ring();
+    const uint32_t h = r->head.load(std::memory_order_relaxed);
+    TraceSlot& e = r->events[h & (RING_SIZE - 1)];
+    e.name.store(name, std::memory_order_relaxed);
+    e.t0.store(t0, std::memory_order_relaxed);
+    e.t1.store(t1, std::memory_order_relaxed);
+    r->head.store(h + 1, std::memory_order_release);
+}
+
+static void write_escaped(FILE* f, const char* s) {
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+}
+
+bool stage_trace_write_json(const char* path) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) { std::printf("trace: couldn't write '%s'\n", path); return false; }
+
+    std::lock_guard<std::mutex> lock(g_rings_mtx);
+    std::vector<TraceEvent> snap;
+    size_t total = 0;
+    bool first = true;
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (auto& rp : g_rings) {
+        TraceRing* r = rp.get();
+        const char* thread_name = r->thread_name.load(std::memory_order_relaxed);
+        if (thread_name) {
+            std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+                         first ? "" : ",\n", r->tid);
+            write_escaped(f, thread_name);
+            std::fprintf(f, "\"}}");
+            first = false;
+        }
+        // Yazar durmaz: kopyalarken üzerine yazılmış olabilecek en eski olaylar atılır
+        const uint32_t h0 = r->head.load(std::memory_order_acquire);
+        const uint32_t n = h0 < RING_SIZE ? h0 : RING_SIZE;
+        snap.resize(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            const TraceSlot& e = r->events[(h0 - n + i) & (RING_SIZE - 1)];
+            snap[i] = { e.name.load(std::memory_order_relaxed), e.t0.load(std::memory_order_relaxed),
+                        e.t1.load(std::memory_order_relaxed) };
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint32_t h1 = r->head.load(std::memory_order_relaxed);
+        // Halka dolduysa yazarın o an doldurduğu slot (h1) da snap[h1 - h0]'dir: o da atılır
+        const uint32_t dirty = h1 - h0 + (h0 >= RING_SIZE ? 1 : 0);
+        const uint32_t overwritten = dirty < n ? dirty : n;
+        for (uint32_t i = overwritten; i < n; ++i) {
+            const TraceEvent& e = snap[i];
+            std::fprintf(f, "%s{\"name\":\"", first ? "" : ",\n");
+            write_escaped(f, e.name);
+            std::fprintf(f, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         r->tid, (e.t0 - g_epoch) * 1e6, (e.t1 - e.t0) * 1e6);
+            first = false;
+            ++total;
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    const bool ok = std::fclose(f) == 0;
+    std::printf("trace: %zu event(s) from %zu thread(s) written to %s\n", total, g_rings.size(), path);
+    return ok;
+}
@@ -0,0 +1,119 @@
+#include "video_decoder.hpp"
+#include "stage_trace.hpp"
+#include <chrono>
+#include <cstdio>
+
+static void decoder_loop(VideoDecoderState* st) {
+    stage_trace_thread_name("video decode");
+    std::unique_lock<std::mutex> lock(st->mtx);
+    while (true) {
+        st->cv.wait(lock, [st] {
+            return st->quit || (!st->eof && st->count < st->capacity);
+        });
+        if (st->quit) break;
+
+        // count < capacity: slots[write_idx] belongs to the producer until published
+        VideoFrameSlot& slot = st->slots[st->write_idx];
+        lock.unlock();
+
+        int64_t pts = 0;
+        const double decode0 = st->reader->stat_decode_sec;
+        bool ok = video_reader_read_frame(st->reader, slot.frame, &pts);
+        const double decode_sec = st->reader->stat_decode_sec - decode0;
+
+        lock.lock();
+        // demuxer_seek bumps the queue serial before video_decoder_flush takes
+        // this lock, so a stale frame/EOF is always caught by one of the two.
+        if (st->reader->serial != packet_queue_serial(st->reader->pkt_queue)) {
+            av_frame_unref(slot.frame);
+            continue;
+        }
+        if (!ok) { st->eof = true; st->cv.notify_all(); continue; }
+        slot.pts    = pts;
+        slot.serial = st->reader->serial;
+        slot.decode_sec = decode_sec;
+        st->write_idx = (st->write_idx + 1) % st->capacity;
+        st->count++;
+        st->cv.notify_all(); // video_decoder_wait_frame
+    }
+}
+
+bool video_decoder_start(VideoDecoderState* st, VideoReaderState* reader, int capacity) {
+    if (!st || !reader || capacity < 1) return false;
+    st->reader   = reader;
+    st->capacity = capacity;
+    st->slots.assign(capacity, VideoFrameSlot{});
+    for (auto& s : st->slots) {
+        s.frame = av_frame_alloc();
+        if (!s.frame) { std::printf("video: frame alloc failed\n"); return false; }
+    }
+    st->read_idx = st->write_idx = st->count = 0;
+    st->eof = false; st->quit = false;
+    st->thread = std::thread(decoder_loop, st);
+    return true;
+}
+
+const VideoFrameSlot* video_decoder_peek(VideoDecoderState* st) {
+    std::lock_guard<std::mutex> lock(st->mtx);
+    if (st->count == 0) return nullptr;
+    return &st->slots[st->read_idx];
+}
+
+const VideoFrameSlot* video_decoder_peek_next(VideoDecoderState* st) {
+    std::lock_guard<std::mutex> lock(st->mtx);
+    if (st->count < 2) return nullptr;
+    return &st->slots[(st->read_idx + 1) % st->capacity];
+}
+
+void video_decoder_pop(VideoDecoderState* st) {
+    {
+        std::lock_guard<std::mutex> lock(st->mtx);
+        if (st->count == 0) return;
+        av_frame_unref(st->slots[st->read_idx].frame);
+        st->read_idx = (st->read_idx + 1) % st->capacity;
+        st->count--;
+    }
+    st->cv.notify_one();
+}
+
+const VideoFrameSlot* video_decoder_wait_frame(VideoDecoderState* st, double timeout_sec) {
+    std::unique_lock<std::mutex> lock(st->mtx);
+    st->cv.wait_for(lock, std::chrono::duration<double>(timeout_sec),
+                    [st] { return st->count > 0 || st->eof || st->quit; });
+    if (st->count == 0) return nullptr;
+    return &st->slots[st->read_idx];
+}
+
+int video_decoder_ready(VideoDecoderState* st) {
+    std::lock_guard<std::mutex> lock(st->mtx);
+    return st->count;
+}
+
+bool video_decoder_eof(VideoDecoderState* st) {
+    std::lock_guard<std::mutex> lock(st->mtx);
+    return st->eof && st->count == 0;
+}
+
+void video_decoder_flush(VideoDecoderState* st) {
+    {
+        std::lock_guard<std::mutex> lock(st->mtx);
+        for (; st->count > 0; st->count--) {
+            av_frame_unref(st->slots[st->read_idx].frame);
+            st->read_idx = (st->read_idx + 1) % st->capacity;
+        }
+        st->eof = false;
+    }
+    st->cv.notify_one();
+}
+
+void video_decoder_stop(VideoDecoderState* st) {
+    {
+        std::lock_guard<std::mutex> lock(st->mtx);
+        st->quit = true;
+    }
+    st->cv.notify_all();
+    if (st->thread.joinable()) st->thread.join();
+    for (auto& s : st->slots) av_frame_free(&s.frame);
+    st->slots.clear();
+    st->count = 0;
+}
@@ -0,0 +1,60 @@
+#ifndef video_decoder_hpp
+#define video_decoder_hpp
+
+#include "video_reader.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Arka planda çözülmüş kare (decoder formatında, ref-counted). Renk dönüşümü
+// sunumda video_reader_convert ile yapılır; atılan kareler hiç dönüştürülmez.
+struct VideoFrameSlot {
+    AVFrame* frame  = nullptr;
+    int64_t  pts    = 0;       // stream time_base
+    int      serial = 0;
+    double   decode_sec = 0.0; // bu kare için decoder'da geçen süre (istatistik)
+};
+
+struct VideoDecoderState {
+    // Public
+    int capacity = 0;
+
+    // Private (producer thread decodes with `reader`; the consumer only converts)
+    VideoReaderState*           reader = nullptr;
+    std::vector<VideoFrameSlot> slots;
+    int                         read_idx = 0, write_idx = 0, count = 0;
+    bool                        eof = false, quit = false;
+    std::mutex                  mtx;
+    std::condition_variable     cv;
+    std::thread                 thread;
+};
+
+// Starts a producer thread that decodes `reader` ahead into `capacity` frames.
+bool video_decoder_start(VideoDecoderState* st, VideoReaderState* reader, int capacity = 8);
+void video_decoder_stop(VideoDecoderState* st);
+
+// Consumer side (render thread), never blocks on decode.
+// peek: oldest ready frame or nullptr; pop: unrefs it and hands the slot back
+// to the producer.
+const VideoFrameSlot* video_decoder_peek(VideoDecoderState* st);
+void video_decoder_pop(VideoDecoderState* st);
+// Blocks until a frame is ready (returns it like peek), or returns nullptr
+// at EOF or after `timeout_sec`. For seek/startup, not the render loop.
+const VideoFrameSlot* video_decoder_wait_frame(VideoDecoderState* st, double timeout_sec);
+// the frame after peek() (for late-frame dropping), or nullptr
+const VideoFrameSlot* video_decoder_peek_next(VideoDecoderState* st);
+
+// frames decoded and waiting (for diagnostics)
+int video_decoder_ready(VideoDecoderState* st);
+
+// true once the reader hit EOF and every queued frame was consumed
+bool video_decoder_eof(VideoDecoderState* st);
+
+// Drops queued frames; call right after demuxer_seek. Frames decoded from
+// pre-seek packets (older packet queue serial) are discarded by the producer.
+void video_decoder_flush(VideoDecoderState* st);
+
+#endif
@@ -1,9 +1,12 @@
 extern "C" {
 #include <libavutil/error.h>
+#include <libavutil/pixdesc.h>
 }
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include "video_reader.hpp"
+#include "stage_trace.hpp"
 
 // C++ uyumlu wrapper
 static inline const char* av_err2str_cpp(int errnum) {
@@ -16,7 +19,8 @@ static inline const char* av_err2str_cpp(int errnum) {
 #endif
 #define av_err2str(e) av_err2str_cpp((e))
 
-bool video_reader_open(VideoReaderState* state, const char* filename) {
+bool video_reader_open(VideoReaderState* state, DemuxerState* demuxer,
+                       const VideoDecodeOptions& opts) {
     auto& width            = state->width;
     auto& height           = state->height;
     auto& time_base        = state->time_base;
@@ -26,49 +30,44 @@ bool video_reader_open(VideoReaderState* state, const char* filename) {
     auto& av_frame         = state->av_frame;
     auto& av_packet        = state->av_packet;
 
-    av_format_ctx = avformat_alloc_context();
-    if (!av_format_ctx) {
-        std::printf("Couldn't created AVFormatContext\n");
-        return false;
-    }
-    int err = avformat_open_input(&av_format_ctx, filename, NULL, NULL);
-    if (err < 0) {
-        std::fprintf(stderr, "Couldn't open video file '%s': %s\n", filename, av_err2str(err));
-        return false;
-    }
-
-    video_stream_idx = -1;
-    AVCodecParameters* av_codec_params = nullptr;
-    const AVCodec* av_codec = nullptr;
-
-    for (unsigned i = 0; i < av_format_ctx->nb_streams; ++i) {
-        auto* st = av_format_ctx->streams[i];
-        auto* params = st->codecpar;
-        const AVCodec* dec = avcodec_find_decoder(params->codec_id);
-        if (!dec) continue;
-        if (params->codec_type == AVMEDIA_TYPE_VIDEO) {
-            video_stream_idx = (int)i;
-            av_codec_params = params;
-            av_codec = dec;
-            width  = params->width;
-            height = params->height;
-            time_base = st->time_base;
-            break;
-        }
-    }
+    av_format_ctx    = demuxer->fmt;
+    video_stream_idx = demuxer->video_stream_index;
     if (video_stream_idx == -1) {
         std::printf("Couldn't find valid video stream inside file\n");
         return false;
     }
 
+    AVStream* st = av_format_ctx->streams[video_stream_idx];
+    AVCodecParameters* av_codec_params = st->codecpar;
+    const AVCodec* av_codec = avcodec_find_decoder(av_codec_params->codec_id);
+    width  = av_codec_params->width;
+    height = av_codec_params->height;
+    time_base = st->time_base;
+
     av_codec_ctx = avcodec_alloc_context3(av_codec);
     if (!av_codec_ctx) { std::printf("Couldn't create AVCodecContext\n"); return false; }
     if (avcodec_parameters_to_context(av_codec_ctx, av_codec_params) < 0) {
         std::printf("Couldn't initialize AVCodecContext\n"); return false;
     }
+    // avcodec_open2'den önce ayarlanmalı
+    av_codec_ctx->thread_count = opts.thread_count > 0 ? opts.thread_count : 0;
+    switch (opts.thread_mode) {
+        case VIDEO_THREADS_FRAME: av_codec_ctx->thread_type = FF_THREAD_FRAME; break;
+        case VIDEO_THREADS_SLICE: av_codec_ctx->thread_type = FF_THREAD_SLICE; break;
+        default:                  av_codec_ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE; break;
+    }
+    // Kare buffer'ları havuzdan (kapasite aşağıda, thread sayısı belli olunca)
+    if (opts.frame_pool >= 0) {
+        av_codec_ctx->opaque = &state->frame_pool;
+        av_codec_ctx->get_buffer2 = decoder_frame_pool_get_buffer;
+    }
     if (avcodec_open2(av_codec_ctx, av_codec, NULL) < 0) {
         std::printf("Couldn't open codec\n"); return false;
     }
+    // Otomatik: referans kareler (h264'te en fazla 16) + frame thread'lerinin
+    // tuttukları + video_decoder kuyruğu (8) + sunumdaki/geçişteki birkaç kare
+    state->frame_pool.capacity = opts.frame_pool > 0 ? opts.frame_pool
+                                                     : 16 + av_codec_ctx->thread_count + 8 + 4;
 
     av_frame  = av_frame_alloc();
     av_packet = av_packet_alloc();
@@ -77,71 +76,263 @@ bool video_reader_open(VideoReaderState* state, const char* filename) {
         return false;
     }
     state->sws_scaler_ctx = nullptr;
+    state->stat_decode_sec = state->stat_scale_sec = 0.0;
+    state->stat_seek_dropped = 0;
+    state->stat_seek_sec = 0.0;
+    state->accurate_seek = opts.accurate_seek;
+
+    // Dönüşüm bantları: 720p altında tek thread yeter (thread senkronu pahalı)
+    int threads = opts.convert_threads > 0 ? opts.convert_threads
+                                           : (int)std::thread::hardware_concurrency();
+    if (opts.convert_threads <= 0 && height < 720) threads = 1;
+    threads = std::max(1, std::min(threads, std::min(16, height / 64)));
+    state->convert_threads = threads;
+    worker_pool_start(&state->convert_pool, threads - 1);
+    state->simd_convert = opts.simd_convert;
+    state->yuv_key = -1;
+    state->convert_kernel = nullptr;
+    state->yuv_ok = false;
+    state->slice_fmt = AV_PIX_FMT_NONE;
+    state->scale_to_display = opts.scale_to_display;
+    state->out_width  = width;
+    state->out_height = height;
+    state->seek_target_pts = AV_NOPTS_VALUE;
+    state->serial = packet_queue_serial(&demuxer->video_q);
+    state->pkt_queue = &demuxer->video_q;
+    state->pkt_queue->enabled = true;
     return true;
 }
 
-bool video_reader_read_frame(VideoReaderState* state, uint8_t* frame_buffer, int64_t* pts) {
-    auto& av_format_ctx    = state->av_format_ctx;
+// Karenin süresi (stream time_base); bilinmiyorsa ortalama kare hızından
+static int64_t frame_duration(const VideoReaderState* state, const AVFrame* frame) {
+#if LIBAVUTIL_VERSION_MAJOR >= 58
+    if (frame->duration > 0) return frame->duration;
+#else
+    if (frame->pkt_duration > 0) return frame->pkt_duration;
+#endif
+    AVRational fr = state->av_format_ctx->streams[state->video_stream_index]->avg_frame_rate;
+    if (fr.num <= 0 || fr.den <= 0) return 0;
+    return (int64_t)llround(fr.den * (double)state->time_base.den / ((double)fr.num * state->time_base.num));
+}
+
+static int64_t frame_pts(const AVFrame* frame) {
+    return frame->best_effort_timestamp == AV_NOPTS_VALUE ? frame->pts : frame->best_effort_timestamp;
+}
+
+bool video_reader_read_frame(VideoReaderState* state, AVFrame* frame, int64_t* pts) {
     auto& av_codec_ctx     = state->av_codec_ctx;
-    auto& video_stream_idx = state->video_stream_index;
     auto& av_frame         = state->av_frame;
     auto& av_packet        = state->av_packet;
-    auto& sws_scaler_ctx   = state->sws_scaler_ctx;
-    auto& width            = state->width;
-    auto& height           = state->height;
 
     int response = 0;
-    while (av_read_frame(av_format_ctx, av_packet) >= 0) {
-        if (av_packet->stream_index != video_stream_idx) {
-            av_packet_unref(av_packet);
+    while (true) {
+        // Önce decoder'da bekleyen kare var mı bak (frame threading birkaç kare geride tutar)
+        double t0 = stage_clock_now();
+        response = avcodec_receive_frame(av_codec_ctx, av_frame);
+        stage_trace_add(&state->stat_decode_sec, "video decode", t0);
+        if (response >= 0) {
+            if (state->seek_target_pts == AV_NOPTS_VALUE) break;
+            // Accurate seek: hedefe kadar olan kareler sws_scale'e hiç girmeden atılır
+            int64_t fpts = frame_pts(av_frame);
+            if (fpts != AV_NOPTS_VALUE &&
+                fpts + frame_duration(state, av_frame) <= state->seek_target_pts) {
+                av_frame_unref(av_frame);
+                state->stat_seek_dropped++;
+                continue;
+            }
+            state->seek_target_pts = AV_NOPTS_VALUE;
+            av_codec_ctx->skip_frame = AVDISCARD_DEFAULT;
+            state->stat_seek_sec = stage_clock_now() - state->seek_t0;
+            break;
+        }
+        if (response != AVERROR(EAGAIN) && response != AVERROR_EOF) {
+            std::printf("Failed to receive frame: %s\n", av_err2str(response));
+            return false;
+        }
+
+        int serial = 0;
+        int got = packet_queue_get(state->pkt_queue, av_packet, &serial, true);
+        if (serial != state->serial) {
+            // demuxer seek etti: eski referans kareleri at (drain edilmiş decoder'ı da açar)
+            avcodec_flush_buffers(av_codec_ctx);
+            state->serial = serial;
+            av_codec_ctx->skip_frame = AVDISCARD_DEFAULT;
+            state->seek_target_pts = AV_NOPTS_VALUE;
+            double target_sec = 0.0;
+            if (state->accurate_seek &&
+                packet_queue_serial_start(state->pkt_queue, serial, &target_sec)) {
+                state->seek_target_pts = (int64_t)llround(target_sec * state->time_base.den /
+                                                          (double)state->time_base.num);
+                state->seek_t0 = stage_clock_now();
+                state->stat_seek_dropped = 0;
+            }
+        } else if (response == AVERROR_EOF) {
+            return false; // tamamen drain edildi
+        }
+        if (got < 0) {
+            // EOF: NULL paket decoder'ı drain moduna alır, geride tutulan kareler
+            // sonraki receive_frame çağrılarıyla çıkar.
+            avcodec_send_packet(av_codec_ctx, NULL);
             continue;
         }
+        if (state->seek_target_pts != AV_NOPTS_VALUE) {
+            // Hedeften önce biten paketlerin karesi gösterilmeyecek; referans
+            // olmayanları decoder hiç çözmesin (referanslar sonraki kareler için gerekli)
+            bool before = av_packet->pts != AV_NOPTS_VALUE &&
+                          av_packet->pts + (av_packet->duration > 0 ? av_packet->duration : 0) <= state->seek_target_pts;
+            av_codec_ctx->skip_frame = before ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+        }
+        t0 = stage_clock_now();
         response = avcodec_send_packet(av_codec_ctx, av_packet);
+        stage_trace_add(&state->stat_decode_sec, "video decode", t0);
         av_packet_unref(av_packet);
         if (response < 0) {
             std::printf("Failed to decode packet: %s\n", av_err2str(response));
             return false;
         }
-        response = avcodec_receive_frame(av_codec_ctx, av_frame);
-        if (response == AVERROR(EAGAIN) || response == AVERROR_EOF) {
-            continue;
-        } else if (response < 0) {
-            std::printf("Failed to receive frame: %s\n", av_err2str(response));
-            return false;
-        }
-        break;
     }
 
     // PTS: best_effort_timestamp öncelikli
-    int64_t ts = (av_frame->best_effort_timestamp == AV_NOPTS_VALUE)
-                 ? av_frame->pts
-                 : av_frame->best_effort_timestamp;
-    *pts = ts;
+    *pts = frame_pts(av_frame);
+    av_frame_unref(frame);
+    av_frame_move_ref(frame, av_frame);
+    return true;
+}
 
-    if (!sws_scaler_ctx) {
-        sws_scaler_ctx = sws_getContext(width, height, av_codec_ctx->pix_fmt,
-                                        width, height, AV_PIX_FMT_RGB0,
-                                        SWS_BILINEAR, NULL, NULL, NULL);
+// Bantları ve her birinin scaler'ını kurar. Kaynak ve hedef aynı boyutta
+// olduğundan (dikey ölçekleme yok) her bant kendi yüksekliğinde bağımsız bir
+// resim gibi dönüştürülür; bantlar chroma satır sınırında bölünür.
+static bool init_slices(VideoReaderState* state, AVPixelFormat fmt) {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(fmt);
+    if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL)))
+        return false;
+    // bant sınırları chroma satırına denk gelmeli
+    const int align = std::max(16, 1 << desc->log2_chroma_h);
+    const int n = state->convert_threads;
+    state->slice_y.clear();
+    for (int i = 0; i < n; ++i) state->slice_y.push_back((state->height * i / n) / align * align);
+    state->slice_y.push_back(state->height);
+    for (int i = 0; i < n; ++i) {
+        const int h = state->slice_y[i + 1] - state->slice_y[i];
+        SwsContext* ctx = h > 0 ? sws_getContext(state->width, h, fmt, state->width, h, AV_PIX_FMT_RGB0,
+                                                 SWS_BILINEAR, NULL, NULL, NULL)
+                                : nullptr;
+        state->slice_ctx.push_back(ctx);
+        if (h > 0 && !ctx) return false;
+    }
+    return true;
+}
+
+static void free_slices(VideoReaderState* state) {
+    for (SwsContext* c : state->slice_ctx) sws_freeContext(c);
+    state->slice_ctx.clear();
+    state->slice_y.clear();
+}
+
+bool video_reader_convert(VideoReaderState* state, const AVFrame* frame,
+                          uint8_t* frame_buffer, int stride) {
+    auto& sws_scaler_ctx = state->sws_scaler_ctx;
+    const int width  = state->width;
+    const int height = state->height;
+
+    // Aynı boyutta yaygın formatlar: elle yazılmış SIMD dönüştürücü
+    // Format/renk etiketleri akış ortasında değişebilir: her karede anahtar
+    // karşılaştırılır, değişince dönüştürücü yeniden kurulur ya da swscale'e düşülür
+    if (state->simd_convert) {
+        YuvMatrix matrix; bool full_range;
+        const bool color_ok = yuv_frame_color(frame, &matrix, &full_range);
+        const int key = color_ok ? frame->format * 4 + (int)matrix * 2 + (full_range ? 1 : 0) : -2;
+        if (key != state->yuv_key) {
+            state->yuv_ok = color_ok && yuv_converter_init(&state->yuv, (AVPixelFormat)frame->format,
+                                                           matrix, full_range);
+            state->yuv_key = key;
+        }
+    }
+    // Çizilen boyuta ölçekleme: bantlara bölünemez (dikey filtre bant sınırını aşar),
+    // tek scaler; kaynak yine okunur ama yazılan/yüklenen piksel sayısı düşer
+    const bool same_size = frame->width == width && frame->height == height &&
+                           state->out_width == width && state->out_height == height;
+    if (state->simd_convert && state->yuv_ok && same_size) {
+        const int n = state->convert_threads;
+        double t0 = stage_clock_now();
+        worker_pool_run(&state->convert_pool, n, [&](int i) {
+            const int y0 = (height * i / n) & ~1;
+            const int y1 = (i + 1 == n) ? height : (height * (i + 1) / n) & ~1;
+            STAGE_SCOPE("convert slice");
+            yuv_converter_run(&state->yuv, frame, frame_buffer, stride, y0, y1);
+        });
+        stage_trace_add(&state->stat_scale_sec, "yuv convert", t0);
+        state->convert_kernel = yuv_kernel_name(state->yuv.kernel);
+        return true;
+    }
+
+    if (!state->slice_ctx.empty() && state->slice_fmt != frame->format) free_slices(state);
+    if (same_size && state->convert_threads > 1 && state->slice_ctx.empty()) {
+        state->slice_fmt = frame->format;
+        if (!init_slices(state, (AVPixelFormat)frame->format)) {
+            free_slices(state);
+            state->convert_threads = 1; // tek parça dönüşüme düş
+        }
+    }
+    if (same_size && state->convert_threads > 1) {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get((AVPixelFormat)frame->format);
+        double t0 = stage_clock_now();
+        worker_pool_run(&state->convert_pool, (int)state->slice_ctx.size(), [&](int i) {
+            const int y = state->slice_y[i];
+            const int h = state->slice_y[i + 1] - y;
+            if (h <= 0) return;
+            STAGE_SCOPE("sws_scale slice");
+            const uint8_t* src[4];
+            for (int p = 0; p < 4; ++p) {
+                const int py = (p == 1 || p == 2) ? (y >> desc->log2_chroma_h) : y;
+                src[p] = frame->data[p] ? frame->data[p] + (ptrdiff_t)py * frame->linesize[p] : nullptr;
+            }
+            uint8_t* dest[4] = { frame_buffer + (ptrdiff_t)y * stride, NULL, NULL, NULL };
+            int dest_linesize[4] = { stride, 0, 0, 0 };
+            sws_scale(state->slice_ctx[i], src, frame->linesize, 0, h, dest, dest_linesize);
+        });
+        stage_trace_add(&state->stat_scale_sec, "sws_scale", t0);
+        state->convert_kernel = "swscale";
+        return true;
     }
+
+    // Boyut/format değişmediyse aynı context döner
+    sws_scaler_ctx = sws_getCachedContext(sws_scaler_ctx, frame->width, frame->height,
+                                          (AVPixelFormat)frame->format,
+                                          state->out_width, state->out_height, AV_PIX_FMT_RGB0,
+                                          SWS_BILINEAR, NULL, NULL, NULL);
     if (!sws_scaler_ctx) {
         std::printf("Couldn't initialize sw scaler\n");
         return false;
     }
     uint8_t* dest[4] = { frame_buffer, NULL, NULL, NULL };
-    int dest_linesize[4] = { width * 4, 0, 0, 0 };
-    sws_scale(sws_scaler_ctx, av_frame->data, av_frame->linesize, 0, av_frame->height,
+    int dest_linesize[4] = { stride, 0, 0, 0 };
+    double t0 = stage_clock_now();
+    sws_scale(sws_scaler_ctx, frame->data, frame->linesize, 0, frame->height,
               dest, dest_linesize);
+    stage_trace_add(&state->stat_scale_sec, "sws_scale", t0);
+    state->convert_kernel = "swscale";
     return true;
 }
 
-bool video_reader_seek(VideoReaderState* s, double seconds) {
-    if (!s || !s->av_format_ctx) return false;
-    int64_t ts = (int64_t)llround(seconds * s->time_base.den / (double)s->time_base.num);
-    if (av_seek_frame(s->av_format_ctx, s->video_stream_index, ts, AVSEEK_FLAG_BACKWARD) < 0)
-        return false;
-    avcodec_flush_buffers(s->av_codec_ctx);
-    if (s->av_packet) av_packet_unref(s->av_packet);
-    if (s->av_frame)  av_frame_unref(s->av_frame);
+bool video_reader_set_output_size(VideoReaderState* state, int draw_w, int draw_h) {
+    if (!state->scale_to_display || draw_w <= 0 || draw_h <= 0) return false;
+    // Kaynaktan büyük çizimde tam çözünürlük yeter (GPU büyütür)
+    int w = std::min(draw_w, state->width);
+    int h = std::min(draw_h, state->height);
+    const int cw = state->out_width, ch = state->out_height;
+    // Büyüme hemen (yoksa GPU büyütür, görüntü bulanıklaşır), %10 payla;
+    // küçülme ancak iki eksende de %20'yi geçince
+    const bool grow   = w > cw || h > ch;
+    const bool shrink = w * 5 < cw * 4 && h * 5 < ch * 4;
+    if (!grow && !shrink) return false;
+    if (grow) {
+        w = std::min(state->width,  std::max(cw, w + w / 10));
+        h = std::min(state->height, std::max(ch, h + h / 10));
+    }
+    if (w == cw && h == ch) return false;
+    state->out_width  = w;
+    state->out_height = h;
     return true;
 }
 
@@ -158,10 +349,17 @@ double video_reader_get_duration_sec(const VideoReaderState* s) {
 }
 
 void video_reader_close(VideoReaderState* state) {
+    worker_pool_stop(&state->convert_pool);
+    free_slices(state);
     sws_freeContext(state->sws_scaler_ctx);
-    avformat_close_input(&state->av_format_ctx);
-    avformat_free_context(state->av_format_ctx);
+    state->av_format_ctx = nullptr; // demuxer_close kapatır
     av_frame_free(&state->av_frame);
     av_packet_free(&state->av_packet);
     avcodec_free_context(&state->av_codec_ctx);
+    decoder_frame_pool_close(&state->frame_pool); // dışarıda kalan kareler dönünce boşalır
+}
+
+const char* video_reader_threading(const VideoReaderState* s) {
+    const int active = s->av_codec_ctx ? s->av_codec_ctx->active_thread_type : 0;
+    return (active & FF_THREAD_FRAME) ? "frame" : (active & FF_THREAD_SLICE) ? "slice" : "no";
 }
@@ -7,29 +7,97 @@ extern "C"{
 #include <libswscale/swscale.h>
 #include <inttypes.h>
 }
+#include "demuxer.hpp"
+#include "frame_pool.hpp"
+#include "worker_pool.hpp"
+#include "yuv_convert.hpp"
+#include <vector>
+
+// Decoder threading (AVCodecContext::thread_type / thread_count)
+enum VideoThreadMode {
+    VIDEO_THREADS_AUTO,  // frame + slice, codec ne destekliyorsa
+    VIDEO_THREADS_FRAME, // frame threading (throughput, +thread_count kare gecikme)
+    VIDEO_THREADS_SLICE, // slice threading (gecikme yok, codec/encode'a bağlı)
+};
+
+struct VideoDecodeOptions {
+    VideoThreadMode thread_mode  = VIDEO_THREADS_AUTO;
+    int             thread_count = 0; // 0: FFmpeg çekirdek sayısına göre seçer, 1: tek thread
+    bool            accurate_seek = true; // seek sonrası keyframe'den hedef kareye kadar decode et
+    int             convert_threads = 0;  // RGB dönüşümü için thread sayısı, 0: otomatik
+    bool            simd_convert = true;  // yuv420p/nv12/p10 için SIMD dönüştürücü (false: hep swscale)
+    bool            scale_to_display = false; // kareyi çizilen boyuta dönüştür (bkz. video_reader_set_output_size)
+    int             frame_pool = 0;       // decoder kare havuzu kapasitesi, 0: otomatik, <0: kapalı (FFmpeg ayırır)
+};
 
 struct VideoReaderState {
     // Public
     int width, height;
+    // video_reader_convert'in ürettiği boyut (scale_to_display yoksa hep width x height)
+    int out_width, out_height;
     AVRational time_base;
 
+    // serial of the packet queue the last returned frame belongs to
+    int serial;
+
+    // Cumulative stage times (seconds; decode on the decode thread, scale on
+    // whichever thread calls video_reader_convert)
+    double stat_decode_sec, stat_scale_sec;
+    // Last accurate seek: frames decoded and dropped before the target, time spent
+    int    stat_seek_dropped;
+    double stat_seek_sec;
+    // Last conversion's path: SIMD kernel name or "swscale" (nullptr: none yet)
+    const char* convert_kernel;
+
     // Private internal state
-    AVFormatContext* av_format_ctx;
+    AVFormatContext* av_format_ctx; // demuxer'a ait (sadece okunur)
+    PacketQueue*     pkt_queue;
     AVCodecContext*  av_codec_ctx;
+    DecoderFramePool frame_pool;    // get_buffer2: decode edilen karelerin buffer'ları
     int              video_stream_index;
     AVFrame*         av_frame;
     AVPacket*        av_packet;
     SwsContext*      sws_scaler_ctx;
+    // Slice-parallel dönüşüm: her yatay bant kendi scaler'ı ile ayrı bir thread'de
+    std::vector<SwsContext*> slice_ctx;
+    std::vector<int>         slice_y;   // bant başlangıç satırları (+ sonda height)
+    WorkerPool               convert_pool;
+    int                      convert_threads;
+    YuvConverter             yuv;          // simd_convert: format/matris/aralık değişince yeniden kurulur
+    int                      yuv_key;      // yuv'un kurulduğu renk anahtarı, -1: henüz yok
+    bool                     simd_convert, yuv_ok;
+    int                      slice_fmt;    // slice_ctx'in kurulduğu kaynak format
+    bool                     scale_to_display;
+    bool             accurate_seek;
+    int64_t          seek_target_pts; // AV_NOPTS_VALUE: hedef yok
+    double           seek_t0;
 };
 
-bool video_reader_open(VideoReaderState* state, const char* filename);
-bool video_reader_read_frame(VideoReaderState* state, uint8_t* frame_buffer, int64_t* pts);
-void video_reader_close(VideoReaderState* state);
+// Paketler demuxer'ın video kuyruğundan okunur (seek: demuxer_seek).
+bool video_reader_open(VideoReaderState* state, DemuxerState* demuxer,
+                       const VideoDecodeOptions& opts = VideoDecodeOptions());
+// Sıradaki kareyi decode eder ve referansını `frame`'e taşır (dönüşüm yok).
+// Çağıran işi bitince av_frame_unref eder; decoder'ın buffer'ı o ana kadar tutulur.
+bool video_reader_read_frame(VideoReaderState* state, AVFrame* frame, int64_t* pts);
 
-// seek (seconds)
-bool video_reader_seek(VideoReaderState* state, double seconds);
+// Decode edilmiş kareyi out_width x out_height RGB0'a çevirir (sadece gösterilecek
+// kareler için çağrılır). read_frame ile farklı thread'lerden çağrılabilir: sadece
+// scaler'ı kullanır. frame_buffer en az out_height * stride byte olmalı.
+bool video_reader_convert(VideoReaderState* state, const AVFrame* frame,
+                          uint8_t* frame_buffer, int stride);
+
+// scale_to_display: dönüşüm boyutunu ekranda çizilen boyuta (draw_w x draw_h,
+// en fazla kaynak boyutu) getirir. Histerezisli: büyümede biraz pay bırakılır,
+// küçülme ancak belirgin olunca uygulanır; pencere sürüklenirken scaler her karede
+// yeniden kurulmaz. Boyut değiştiyse true (çağıran buffer/texture'ı yeniden kurar).
+// convert ile aynı thread'den çağrılmalı.
+bool video_reader_set_output_size(VideoReaderState* state, int draw_w, int draw_h);
+void video_reader_close(VideoReaderState* state);
 
 // NEW: süre (saniye). Bilinmiyorsa <=0 dönebilir.
 double video_reader_get_duration_sec(const VideoReaderState* state);
 
+// Decoder'ın etkin threading'i: "frame", "slice" ya da "no" (bench/istatistik için).
+const char* video_reader_threading(const VideoReaderState* state);
+
 #endif
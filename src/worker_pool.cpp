@@ -0,0 +1,64 @@
+#include "worker_pool.hpp"
+#include "stage_trace.hpp"
+
+// Kilit altında çağrılır; bir parça alıp kilitsiz çalıştırır
+static bool run_one(WorkerPool* pool, std::unique_lock<std::mutex>& lock) {
+    if (pool->next_task >= pool->task_count) return false;
+    const int i = pool->next_task++;
+    lock.unlock();
+    pool->task(pool->task_ctx, i);
+    lock.lock();
+    if (--pool->pending == 0) pool->done_cv.notify_all();
+    return true;
+}
+
+static void worker_loop(WorkerPool* pool) {
+    stage_trace_thread_name("worker");
+    std::unique_lock<std::mutex> lock(pool->mtx);
+    unsigned seen = pool->generation;
+    while (true) {
+        pool->cv.wait(lock, [&] { return pool->quit || pool->generation != seen; });
+        if (pool->quit) break;
+        seen = pool->generation;
+        while (run_one(pool, lock)) {}
+    }
+}
+
+void worker_pool_start(WorkerPool* pool, int workers) {
+    pool->quit = false;
+    for (int i = 0; i < workers; ++i) pool->threads.emplace_back(worker_loop, pool);
+}
+
+void worker_pool_stop(WorkerPool* pool) {
+    {
+        std::lock_guard<std::mutex> lock(pool->mtx);
+        pool->quit = true;
+    }
+    pool->cv.notify_all();
+    for (auto& t : pool->threads) t.join();
+    pool->threads.clear();
+}
+
+int worker_pool_size(const WorkerPool* pool) {
+    return (int)pool->threads.size() + 1;
+}
+
+void worker_pool_run(WorkerPool* pool, int count, void (*fn)(void*, int), void* ctx) {
+    if (count <= 0) return;
+    if (count == 1 || pool->threads.empty()) {
+        for (int i = 0; i < count; ++i) fn(ctx, i);
+        return;
+    }
+    std::unique_lock<std::mutex> lock(pool->mtx);
+    pool->task       = fn;
+    pool->task_ctx   = ctx;
+    pool->task_count = count;
+    pool->next_task  = 0;
+    pool->pending    = count;
+    pool->generation++;
+    pool->cv.notify_all();
+    while (run_one(pool, lock)) {}
+    pool->done_cv.wait(lock, [pool] { return pool->pending == 0; });
+    pool->task = nullptr;
+    pool->task_ctx = nullptr;
+}
@@ -0,0 +1,39 @@
+#ifndef worker_pool_hpp
+#define worker_pool_hpp
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Sabit sayıda worker thread; worker_pool_run bir işi N parçaya böler ve
+// hepsi bitene kadar bekler (çağıran thread de parça işler).
+struct WorkerPool {
+    // Private
+    std::vector<std::thread>  threads;
+    std::mutex                mtx;
+    std::condition_variable   cv, done_cv;
+    void                    (*task)(void*, int) = nullptr; // çağıran run'da bekler: sahiplik yok
+    void*                     task_ctx = nullptr;
+    int                       task_count = 0, next_task = 0, pending = 0;
+    unsigned                  generation = 0;
+    bool                      quit = false;
+};
+
+// `workers` ek thread başlatır (0: pool sadece çağıran thread'de çalışır)
+void worker_pool_start(WorkerPool* pool, int workers);
+void worker_pool_stop(WorkerPool* pool);
+int  worker_pool_size(const WorkerPool* pool); // workers + çağıran
+
+// fn(ctx, 0..count-1), dönünce hepsi tamamlanmış olur. Aynı anda tek çağıran.
+void worker_pool_run(WorkerPool* pool, int count, void (*fn)(void*, int), void* ctx);
+
+// Lambda ile: fn çağıranın yığınında kalır, kare başına allocation yok
+template <typename F>
+void worker_pool_run(WorkerPool* pool, int count, F&& fn) {
+    typedef typename std::remove_reference<F>::type Fn;
+    worker_pool_run(pool, count, [](void* ctx, int i) { (*(Fn*)ctx)(i); }, (void*)&fn);
+}
+
+#endif
@@ -0,0 +1,270 @@
+#include "yuv_convert.hpp"
+#include <cmath>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define YUV_X86 1
+#include <immintrin.h>
+#endif
+
+static const int SHIFT = 14;
+static const int ROUND = 1 << (SHIFT - 1);
+
+static inline uint32_t load_u32(const void* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+static inline uint16_t load_u16(const void* p) { uint16_t v; std::memcpy(&v, p, 2); return v; }
+
+static inline uint8_t clamp_u8(int32_t v) { return (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v); }
+
+// Tek piksel; SIMD kernel'ler aynı işlem sırasını izler (bit-exact)
+static inline void store_px(uint8_t* d, int32_t Y, int32_t U, int32_t V, const YuvCoeffs* c) {
+    const int32_t y = (Y - c->yoff) * c->ycoef + ROUND;
+    const int32_t u = U - c->coff, v = V - c->coff;
+    d[0] = clamp_u8((y + v * c->rv) >> SHIFT);
+    d[1] = clamp_u8((y - u * c->gu - v * c->gv) >> SHIFT);
+    d[2] = clamp_u8((y + u * c->bu) >> SHIFT);
+    d[3] = 255;
+}
+
+// --- Scalar ---
+
+static void row_planar8_scalar(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                               uint8_t* dst, int w, const YuvCoeffs* c) {
+    for (int x = 0; x < w; ++x) store_px(dst + 4 * x, y[x], u[x >> 1], v[x >> 1], c);
+}
+
+static void row_nv12_scalar(const uint8_t* y, const uint8_t* uv, const uint8_t*,
+                            uint8_t* dst, int w, const YuvCoeffs* c) {
+    for (int x = 0; x < w; ++x) store_px(dst + 4 * x, y[x], uv[x & ~1], uv[x | 1], c);
+}
+
+static void row_planar10_scalar(const uint8_t* y8, const uint8_t* u8, const uint8_t* v8,
+                                uint8_t* dst, int w, const YuvCoeffs* c) {
+    const uint16_t* y = (const uint16_t*)y8;
+    const uint16_t* u = (const uint16_t*)u8;
+    const uint16_t* v = (const uint16_t*)v8;
+    for (int x = 0; x < w; ++x) store_px(dst + 4 * x, y[x], u[x >> 1], v[x >> 1], c);
+}
+
+#ifdef YUV_X86
+// --- SSE4.1: 4 piksel ---
+
+__attribute__((target("sse4.1")))
+static inline __m128i rgba_sse4(__m128i Y, __m128i U, __m128i V, const YuvCoeffs* c) {
+    const __m128i zero = _mm_setzero_si128(), max = _mm_set1_epi32(255);
+    __m128i y = _mm_add_epi32(_mm_mullo_epi32(_mm_sub_epi32(Y, _mm_set1_epi32(c->yoff)),
+                                              _mm_set1_epi32(c->ycoef)), _mm_set1_epi32(ROUND));
+    __m128i u = _mm_sub_epi32(U, _mm_set1_epi32(c->coff));
+    __m128i v = _mm_sub_epi32(V, _mm_set1_epi32(c->coff));
+    __m128i r = _mm_srai_epi32(_mm_add_epi32(y, _mm_mullo_epi32(v, _mm_set1_epi32(c->rv))), SHIFT);
+    __m128i g = _mm_srai_epi32(_mm_sub_epi32(_mm_sub_epi32(y, _mm_mullo_epi32(u, _mm_set1_epi32(c->gu))),
+                                             _mm_mullo_epi32(v, _mm_set1_epi32(c->gv))), SHIFT);
+    __m128i b = _mm_srai_epi32(_mm_add_epi32(y, _mm_mullo_epi32(u, _mm_set1_epi32(c->bu))), SHIFT);
+    r = _mm_min_epi32(_mm_max_epi32(r, zero), max);
+    g = _mm_min_epi32(_mm_max_epi32(g, zero), max);
+    b = _mm_min_epi32(_mm_max_epi32(b, zero), max);
+    // little-endian: R, G, B, A byte sırası
+    return _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)),
+                        _mm_or_si128(_mm_slli_epi32(b, 16), _mm_set1_epi32((int)0xFF000000u)));
+}
+
+__attribute__((target("sse4.1")))
+static void row_planar8_sse4(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                             uint8_t* dst, int w, const YuvCoeffs* c) {
+    int x = 0;
+    for (; x + 4 <= w; x += 4) {
+        __m128i Y = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)load_u32(y + x)));
+        __m128i U = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(load_u16(u + x / 2)));
+        __m128i V = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(load_u16(v + x / 2)));
+        U = _mm_shuffle_epi32(U, _MM_SHUFFLE(1, 1, 0, 0));
+        V = _mm_shuffle_epi32(V, _MM_SHUFFLE(1, 1, 0, 0));
+        _mm_storeu_si128((__m128i*)(dst + 4 * x), rgba_sse4(Y, U, V, c));
+    }
+    row_planar8_scalar(y + x, u + x / 2, v + x / 2, dst + 4 * x, w - x, c);
+}
+
+__attribute__((target("sse4.1")))
+static void row_nv12_sse4(const uint8_t* y, const uint8_t* uv, const uint8_t*,
+                          uint8_t* dst, int w, const YuvCoeffs* c) {
+    int x = 0;
+    for (; x + 4 <= w; x += 4) {
+        __m128i Y  = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)load_u32(y + x)));
+        __m128i UV = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((int)load_u32(uv + x))); // u0 v0 u1 v1
+        __m128i U  = _mm_shuffle_epi32(UV, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128i V  = _mm_shuffle_epi32(UV, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_si128((__m128i*)(dst + 4 * x), rgba_sse4(Y, U, V, c));
+    }
+    row_nv12_scalar(y + x, uv + x, nullptr, dst + 4 * x, w - x, c);
+}
+
+__attribute__((target("sse4.1")))
+static void row_planar10_sse4(const uint8_t* y8, const uint8_t* u8, const uint8_t* v8,
+                              uint8_t* dst, int w, const YuvCoeffs* c) {
+    int x = 0;
+    for (; x + 4 <= w; x += 4) {
+        __m128i Y = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(y8 + 2 * x)));
+        __m128i U = _mm_cvtepu16_epi32(_mm_cvtsi32_si128((int)load_u32(u8 + x)));
+        __m128i V = _mm_cvtepu16_epi32(_mm_cvtsi32_si128((int)load_u32(v8 + x)));
+        U = _mm_shuffle_epi32(U, _MM_SHUFFLE(1, 1, 0, 0));
+        V = _mm_shuffle_epi32(V, _MM_SHUFFLE(1, 1, 0, 0));
+        _mm_storeu_si128((__m128i*)(dst + 4 * x), rgba_sse4(Y, U, V, c));
+    }
+    row_planar10_scalar(y8 + 2 * x, u8 + x, v8 + x, dst + 4 * x, w - x, c);
+}
+
+// --- AVX2: 8 piksel ---
+
+__attribute__((target("avx2")))
+static inline __m256i rgba_avx2(__m256i Y, __m256i U, __m256i V, const YuvCoeffs* c) {
+    const __m256i zero = _mm256_setzero_si256(), max = _mm256_set1_epi32(255);
+    __m256i y = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(Y, _mm256_set1_epi32(c->yoff)),
+                                                    _mm256_set1_epi32(c->ycoef)), _mm256_set1_epi32(ROUND));
+    __m256i u = _mm256_sub_epi32(U, _mm256_set1_epi32(c->coff));
+    __m256i v = _mm256_sub_epi32(V, _mm256_set1_epi32(c->coff));
+    __m256i r = _mm256_srai_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(v, _mm256_set1_epi32(c->rv))), SHIFT);
+    __m256i g = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_sub_epi32(y, _mm256_mullo_epi32(u, _mm256_set1_epi32(c->gu))),
+                                                   _mm256_mullo_epi32(v, _mm256_set1_epi32(c->gv))), SHIFT);
+    __m256i b = _mm256_srai_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(u, _mm256_set1_epi32(c->bu))), SHIFT);
+    r = _mm256_min_epi32(_mm256_max_epi32(r, zero), max);
+    g = _mm256_min_epi32(_mm256_max_epi32(g, zero), max);
+    b = _mm256_min_epi32(_mm256_max_epi32(b, zero), max);
+    return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                           _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_set1_epi32((int)0xFF000000u)));
+}
+
+__attribute__((target("avx2")))
+static void row_planar8_avx2(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                             uint8_t* dst, int w, const YuvCoeffs* c) {
+    const __m256i dup = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    int x = 0;
+    for (; x + 8 <= w; x += 8) {
+        __m256i Y = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(y + x)));
+        __m256i U = _mm256_cvtepu8_epi32(_mm_cvtsi32_si128((int)load_u32(u + x / 2)));
+        __m256i V = _mm256_cvtepu8_epi32(_mm_cvtsi32_si128((int)load_u32(v + x / 2)));
+        U = _mm256_permutevar8x32_epi32(U, dup);
+        V = _mm256_permutevar8x32_epi32(V, dup);
+        _mm256_storeu_si256((__m256i*)(dst + 4 * x), rgba_avx2(Y, U, V, c));
+    }
+    row_planar8_scalar(y + x, u + x / 2, v + x / 2, dst + 4 * x, w - x, c);
+}
+
+__attribute__((target("avx2")))
+static void row_nv12_avx2(const uint8_t* y, const uint8_t* uv, const uint8_t*,
+                          uint8_t* dst, int w, const YuvCoeffs* c) {
+    const __m256i even = _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6);
+    const __m256i odd  = _mm256_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7);
+    int x = 0;
+    for (; x + 8 <= w; x += 8) {
+        __m256i Y  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(y + x)));
+        __m256i UV = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(uv + x)));
+        __m256i U  = _mm256_permutevar8x32_epi32(UV, even);
+        __m256i V  = _mm256_permutevar8x32_epi32(UV, odd);
+        _mm256_storeu_si256((__m256i*)(dst + 4 * x), rgba_avx2(Y, U, V, c));
+    }
+    row_nv12_scalar(y + x, uv + x, nullptr, dst + 4 * x, w - x, c);
+}
+
+__attribute__((target("avx2")))
+static void row_planar10_avx2(const uint8_t* y8, const uint8_t* u8, const uint8_t* v8,
+                              uint8_t* dst, int w, const YuvCoeffs* c) {
+    const __m256i dup = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    int x = 0;
+    for (; x + 8 <= w; x += 8) {
+        __m256i Y = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(y8 + 2 * x)));
+        __m256i U = _mm256_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(u8 + x)));
+        __m256i V = _mm256_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(v8 + x)));
+        U = _mm256_permutevar8x32_epi32(U, dup);
+        V = _mm256_permutevar8x32_epi32(V, dup);
+        _mm256_storeu_si256((__m256i*)(dst + 4 * x), rgba_avx2(Y, U, V, c));
+    }
+    row_planar10_scalar(y8 + 2 * x, u8 + x, v8 + x, dst + 4 * x, w - x, c);
+}
+#endif
+
+bool yuv_kernel_supported(YuvKernel k) {
+#ifdef YUV_X86
+    __builtin_cpu_init();
+    if (k == YUV_KERNEL_AVX2) return __builtin_cpu_supports("avx2");
+    if (k == YUV_KERNEL_SSE4) return __builtin_cpu_supports("sse4.1");
+#endif
+    return k == YUV_KERNEL_SCALAR;
+}
+
+YuvKernel yuv_best_kernel() {
+    static const YuvKernel best =
+        yuv_kernel_supported(YUV_KERNEL_AVX2) ? YUV_KERNEL_AVX2 :
+        yuv_kernel_supported(YUV_KERNEL_SSE4) ? YUV_KERNEL_SSE4 : YUV_KERNEL_SCALAR;
+    return best;
+}
+
+const char* yuv_kernel_name(YuvKernel k) {
+    switch (k) {
+        case YUV_KERNEL_AVX2: return "avx2";
+        case YUV_KERNEL_SSE4: return "sse4.1";
+        default:              return "scalar";
+    }
+}
+
+bool yuv_convert_supported(AVPixelFormat fmt) {
+    return fmt == AV_PIX_FMT_YUV420P || fmt == AV_PIX_FMT_YUVJ420P ||
+           fmt == AV_PIX_FMT_NV12    || fmt == AV_PIX_FMT_YUV420P10LE;
+}
+
+bool yuv_frame_color(const AVFrame* frame, YuvMatrix* matrix, bool* full_range) {
+    switch (frame->colorspace) {
+        case AVCOL_SPC_BT709:       *matrix = YUV_BT709; break;
+        case AVCOL_SPC_BT470BG:
+        case AVCOL_SPC_SMPTE170M:   *matrix = YUV_BT601; break;
+        case AVCOL_SPC_UNSPECIFIED: *matrix = frame->height >= 720 ? YUV_BT709 : YUV_BT601; break;
+        default:                    return false; // BT.2020, SMPTE240M, YCgCo...: swscale
+    }
+    *full_range = frame->color_range == AVCOL_RANGE_JPEG || frame->format == AV_PIX_FMT_YUVJ420P;
+    return true;
+}
+
+bool yuv_converter_init(YuvConverter* cv, AVPixelFormat fmt, YuvMatrix matrix, bool full_range,
+                        YuvKernel kernel) {
+    if (!yuv_convert_supported(fmt)) return false;
+    if (!yuv_kernel_supported(kernel)) kernel = YUV_KERNEL_SCALAR;
+
+    const int depth = (fmt == AV_PIX_FMT_YUV420P10LE) ? 10 : 8;
+    const double kr = (matrix == YUV_BT709) ? 0.2126 : 0.299;
+    const double kb = (matrix == YUV_BT709) ? 0.0722 : 0.114;
+    const double kg = 1.0 - kr - kb;
+    const double scale = (double)(1 << (depth - 8));
+    // Kaynak kod değerini 8-bit RGB'ye çeviren ölçekler
+    const double ky = full_range ? 255.0 / ((1 << depth) - 1) : 255.0 / (219.0 * scale);
+    const double kc = full_range ? 255.0 / ((1 << depth) - 1) : 255.0 / (224.0 * scale);
+    const double one = (double)(1 << SHIFT);
+
+    YuvCoeffs& c = cv->coeffs;
+    c.yoff  = full_range ? 0 : (int32_t)(16 * scale);
+    c.coff  = 1 << (depth - 1);
+    c.ycoef = (int32_t)std::lround(ky * one);
+    c.rv    = (int32_t)std::lround(2.0 * (1.0 - kr) * kc * one);
+    c.bu    = (int32_t)std::lround(2.0 * (1.0 - kb) * kc * one);
+    c.gu    = (int32_t)std::lround(2.0 * kb * (1.0 - kb) / kg * kc * one);
+    c.gv    = (int32_t)std::lround(2.0 * kr * (1.0 - kr) / kg * kc * one);
+
+    cv->fmt = fmt;
+    cv->kernel = kernel;
+    const bool nv12 = fmt == AV_PIX_FMT_NV12;
+    cv->row = nv12 ? row_nv12_scalar : depth == 10 ? row_planar10_scalar : row_planar8_scalar;
+#ifdef YUV_X86
+    if (kernel == YUV_KERNEL_AVX2)
+        cv->row = nv12 ? row_nv12_avx2 : depth == 10 ? row_planar10_avx2 : row_planar8_avx2;
+    else if (kernel == YUV_KERNEL_SSE4)
+        cv->row = nv12 ? row_nv12_sse4 : depth == 10 ? row_planar10_sse4 : row_planar8_sse4;
+#endif
+    return true;
+}
+
+void yuv_converter_run(const YuvConverter* cv, const AVFrame* frame,
+                       uint8_t* dst, int stride, int y0, int y1) {
+    const bool nv12 = cv->fmt == AV_PIX_FMT_NV12;
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t* py = frame->data[0] + (ptrdiff_t)y * frame->linesize[0];
+        const uint8_t* pu = frame->data[1] + (ptrdiff_t)(y >> 1) * frame->linesize[1];
+        const uint8_t* pv = nv12 ? nullptr : frame->data[2] + (ptrdiff_t)(y >> 1) * frame->linesize[2];
+        cv->row(py, pu, pv, dst + (ptrdiff_t)y * stride, frame->width, &cv->coeffs);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef yuv_convert_hpp
+#define yuv_convert_hpp
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+#include <cstdint>
+
+// Same-size YUV 4:2:0 -> RGBA (alpha 255) for the common decoder outputs:
+// yuv420p, yuvj420p, nv12 and yuv420p10le. Chroma is not interpolated
+// (nearest, like swscale's unscaled path). Fixed-point Q14 math in 32-bit
+// lanes; every kernel produces bit-identical output.
+enum YuvKernel {
+    YUV_KERNEL_SCALAR,
+    YUV_KERNEL_SSE4,
+    YUV_KERNEL_AVX2,
+};
+
+enum YuvMatrix {
+    YUV_BT601,
+    YUV_BT709,
+};
+
+struct YuvCoeffs {
+    int32_t yoff, coff;         // siyah seviyesi ve chroma sıfırı (kaynak bit derinliğinde)
+    int32_t ycoef;              // Q14
+    int32_t rv, gu, gv, bu;     // Q14
+};
+
+typedef void (*yuv_row_fn)(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                           uint8_t* dst, int width, const YuvCoeffs* c);
+
+struct YuvConverter {
+    AVPixelFormat fmt = AV_PIX_FMT_NONE;
+    YuvKernel     kernel = YUV_KERNEL_SCALAR;
+    YuvCoeffs     coeffs = {};
+    yuv_row_fn    row = nullptr;
+};
+
+// Runtime CPU dispatch (resolved once).
+YuvKernel   yuv_best_kernel();
+bool        yuv_kernel_supported(YuvKernel k);
+const char* yuv_kernel_name(YuvKernel k);
+
+bool yuv_convert_supported(AVPixelFormat fmt);
+
+// Matrix/range from the frame's tags; untagged frames use BT.709 for HD
+// (height >= 720) and BT.601 otherwise, limited range unless yuvj.
+// false for matrices other than BT.601/BT.709 (caller falls back to swscale).
+bool yuv_frame_color(const AVFrame* frame, YuvMatrix* matrix, bool* full_range);
+
+// false if `fmt` is not supported (caller falls back to swscale).
+bool yuv_converter_init(YuvConverter* cv, AVPixelFormat fmt, YuvMatrix matrix, bool full_range,
+                        YuvKernel kernel = yuv_best_kernel());
+
+// Converts rows [y0, y1) of `frame` into `dst` (row y at dst + y * stride).
+// y0 must be even so a band starts on a chroma row.
+void yuv_converter_run(const YuvConverter* cv, const AVFrame* frame,
+                       uint8_t* dst, int stride, int y0, int y1);
+
+#endif